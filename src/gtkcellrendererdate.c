@@ -0,0 +1,762 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+	#include <config.h>
+#endif
+
+#include <string.h>
+
+#include "gtkcellrendererdate.h"
+#include "gtkdateentryprivate.h"
+
+enum
+{
+	PROP_0,
+	PROP_PACKED,
+	PROP_JULIAN,
+	PROP_FORMAT,
+	PROP_SEPARATOR,
+	PROP_TIME_SEPARATOR,
+	PROP_TIME_VISIBLE,
+	PROP_TIME_WITH_SECONDS,
+	PROP_EDITABLE
+};
+
+enum
+{
+	EDITED,
+	LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+static void gtk_cell_renderer_date_class_init (GtkCellRendererDateClass *klass);
+static void gtk_cell_renderer_date_init (GtkCellRendererDate *cell);
+static void gtk_cell_renderer_date_constructed (GObject *object);
+static void gtk_cell_renderer_date_dispose (GObject *object);
+static void gtk_cell_renderer_date_finalize (GObject *object);
+
+static void gtk_cell_renderer_date_set_property (GObject *object,
+                                                 guint property_id,
+                                                 const GValue *value,
+                                                 GParamSpec *pspec);
+static void gtk_cell_renderer_date_get_property (GObject *object,
+                                                 guint property_id,
+                                                 GValue *value,
+                                                 GParamSpec *pspec);
+
+static void gtk_cell_renderer_date_get_preferred_width (GtkCellRenderer *cell,
+                                                        GtkWidget *widget,
+                                                        gint *minimum_size,
+                                                        gint *natural_size);
+static void gtk_cell_renderer_date_get_preferred_height (GtkCellRenderer *cell,
+                                                         GtkWidget *widget,
+                                                         gint *minimum_size,
+                                                         gint *natural_size);
+static void gtk_cell_renderer_date_render (GtkCellRenderer *cell,
+                                           cairo_t *cr,
+                                           GtkWidget *widget,
+                                           const GdkRectangle *background_area,
+                                           const GdkRectangle *cell_area,
+                                           GtkCellRendererState flags);
+static GtkCellEditable *gtk_cell_renderer_date_start_editing (GtkCellRenderer *cell,
+                                                              GdkEvent *event,
+                                                              GtkWidget *widget,
+                                                              const gchar *path,
+                                                              const GdkRectangle *background_area,
+                                                              const GdkRectangle *cell_area,
+                                                              GtkCellRendererState flags);
+
+static void editor_on_editing_done (GtkCellEditable *cell_editable,
+                                    gpointer user_data);
+
+static void gtk_cell_renderer_date_compile_format (GtkCellRendererDate *cell);
+static PangoLayout *gtk_cell_renderer_date_get_layout (GtkCellRendererDate *cell,
+                                                       GtkWidget *widget);
+static void gtk_cell_renderer_date_get_size (GtkCellRendererDate *cell,
+                                             GtkWidget *widget,
+                                             gint *width,
+                                             gint *height);
+
+static GtkCellRendererClass *parent_class = NULL;
+
+
+#define GTK_CELL_RENDERER_DATE_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GTK_TYPE_CELL_RENDERER_DATE, GtkCellRendererDatePrivate))
+
+typedef struct _GtkCellRendererDatePrivate GtkCellRendererDatePrivate;
+struct _GtkCellRendererDatePrivate
+	{
+		gint64 packed;
+
+		const gchar *separator;
+		const gchar *time_separator;
+		const gchar *format;
+		gboolean time_is_visible;
+		gboolean time_with_seconds;
+
+		/* the entry that edits the cells, one for all the rows, and the
+		 * path of the edited one */
+		gboolean editable;
+		GtkWidget *editor;
+		gchar *path;
+
+		/* FALSE while the construct properties are set */
+		gboolean constructed;
+
+		/* the date's format followed by the visible time's fields */
+		GtkDateFormat *compiled;
+
+		/* the layout reused for all the cells, and the text it has: it
+		 * is set again only when a cell's text is different */
+		PangoLayout *layout;
+		guint layout_serial;
+		gchar text[64];
+
+		/* the text's size for the compiled format and the pango
+		 * context's serial: all the values have the same size, so it is
+		 * measured once on the format's template */
+		gboolean size_valid;
+		PangoContext *size_context;
+		guint size_serial;
+		gint size_width;
+		gint size_height;
+	};
+
+G_DEFINE_TYPE (GtkCellRendererDate, gtk_cell_renderer_date, GTK_TYPE_CELL_RENDERER)
+
+static void
+gtk_cell_renderer_date_class_init (GtkCellRendererDateClass *klass)
+{
+	GtkCellRendererClass *cell_class;
+
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	g_type_class_add_private (object_class, sizeof (GtkCellRendererDatePrivate));
+
+	cell_class = (GtkCellRendererClass*) klass;
+	parent_class = g_type_class_peek_parent (klass);
+
+	object_class->set_property = gtk_cell_renderer_date_set_property;
+	object_class->get_property = gtk_cell_renderer_date_get_property;
+	object_class->constructed = gtk_cell_renderer_date_constructed;
+	object_class->dispose = gtk_cell_renderer_date_dispose;
+	object_class->finalize = gtk_cell_renderer_date_finalize;
+
+	cell_class->get_preferred_width = gtk_cell_renderer_date_get_preferred_width;
+	cell_class->get_preferred_height = gtk_cell_renderer_date_get_preferred_height;
+	cell_class->render = gtk_cell_renderer_date_render;
+	cell_class->start_editing = gtk_cell_renderer_date_start_editing;
+
+	g_object_class_install_property (object_class, PROP_PACKED,
+	                                 g_param_spec_int64 ("packed",
+	                                                     "The packed value",
+	                                                     "The date and the time as returned by gtk_date_entry_get_packed(); 0 for an empty cell.",
+	                                                     0,
+	                                                     G_MAXINT64,
+	                                                     0,
+	                                                     G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_JULIAN,
+	                                 g_param_spec_uint ("julian",
+	                                                    "The date as a julian day",
+	                                                    "The date as a GDate's julian day, at midnight; 0 for an empty cell.",
+	                                                    0,
+	                                                    G_MAXINT32,
+	                                                    0,
+	                                                    G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_FORMAT,
+	                                 g_param_spec_string ("format",
+	                                                      "The date's format",
+	                                                      "The date's format; NULL for the locale's one.",
+	                                                      NULL,
+	                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+	g_object_class_install_property (object_class, PROP_SEPARATOR,
+	                                 g_param_spec_string ("separator",
+	                                                      "The separator",
+	                                                      "The separator between day, month and year; NULL for the locale's one.",
+	                                                      NULL,
+	                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+	g_object_class_install_property (object_class, PROP_TIME_SEPARATOR,
+	                                 g_param_spec_string ("time-separator",
+	                                                      "The time separator",
+	                                                      "The separator between hours, minutes and seconds.",
+	                                                      ":",
+	                                                      G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_TIME_VISIBLE,
+	                                 g_param_spec_boolean ("time-visible",
+	                                                       "TRUE to show the time part",
+	                                                       "Determines if the time part of the cell is visible or not.",
+	                                                       FALSE,
+	                                                       G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_TIME_WITH_SECONDS,
+	                                 g_param_spec_boolean ("time-with-seconds",
+	                                                       "TRUE to show the seconds in time part",
+	                                                       "Determines if the seconds in the time part of the cell are visible or not.",
+	                                                       TRUE,
+	                                                       G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_EDITABLE,
+	                                 g_param_spec_boolean ("editable",
+	                                                       "TRUE if it is editable",
+	                                                       "Determines if the user can edit the cells.",
+	                                                       FALSE,
+	                                                       G_PARAM_READWRITE));
+
+	/**
+	 * GtkCellRendererDate::edited:
+	 * @cell: the #GtkCellRendererDate.
+	 * @path: the path of the edited row.
+	 * @packed: the new value, as returned by gtk_date_entry_get_packed();
+	 * 0 if the user cleared it.
+	 *
+	 * Emitted when the user ends the editing of a cell without canceling
+	 * it: the handler must store @packed in the model.
+	 */
+	signals[EDITED] = g_signal_new ("edited",
+	                                G_TYPE_FROM_CLASS (object_class),
+	                                G_SIGNAL_RUN_LAST,
+	                                G_STRUCT_OFFSET (GtkCellRendererDateClass, edited),
+	                                NULL, NULL,
+	                                g_cclosure_marshal_generic,
+	                                G_TYPE_NONE,
+	                                2, G_TYPE_STRING, G_TYPE_INT64);
+}
+
+static void
+gtk_cell_renderer_date_init (GtkCellRendererDate *cell)
+{
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (cell);
+
+	/* the format and the separator are set by the construct properties,
+	 * and the format is compiled once in constructed */
+	priv->format = NULL;
+	priv->separator = NULL;
+	priv->time_separator = g_intern_static_string (":");
+
+	priv->time_is_visible = FALSE;
+	priv->time_with_seconds = TRUE;
+}
+
+static void
+gtk_cell_renderer_date_constructed (GObject *object)
+{
+	GtkCellRendererDate *cell = GTK_CELL_RENDERER_DATE (object);
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (cell);
+
+	if (G_OBJECT_CLASS (parent_class)->constructed != NULL)
+		{
+			G_OBJECT_CLASS (parent_class)->constructed (object);
+		}
+
+	priv->constructed = TRUE;
+
+	gtk_cell_renderer_date_compile_format (cell);
+}
+
+static void
+gtk_cell_renderer_date_dispose (GObject *object)
+{
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (object);
+
+	if (priv->editor != NULL)
+		{
+			g_signal_handlers_disconnect_by_func (priv->editor,
+			                                      editor_on_editing_done,
+			                                      object);
+			g_clear_object (&priv->editor);
+		}
+
+	G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
+static void
+gtk_cell_renderer_date_finalize (GObject *object)
+{
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (object);
+
+	g_free (priv->path);
+
+	if (priv->compiled != NULL)
+		{
+			gtk_date_format_unref (priv->compiled);
+		}
+	g_clear_object (&priv->layout);
+
+	G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+/**
+ * gtk_cell_renderer_date_new:
+ *
+ * Creates a cell renderer that shows a date, and optionally the time, with
+ * the same format of #GtkDateEntry. Bind its "packed" property to a
+ * #G_TYPE_INT64 column with the values of gtk_date_entry_get_packed(), or
+ * its "julian" property to a #G_TYPE_UINT column with julian days.
+ *
+ * The cells are formatted into a buffer of the renderer and drawn with one
+ * #PangoLayout, and their size is measured once for the format, so
+ * rendering a cell doesn't allocate memory. If it is editable, one
+ * #GtkDateEntry edits the cells of all the rows.
+ *
+ * Returns: the newly created #GtkCellRendererDate.
+ */
+GtkCellRenderer
+*gtk_cell_renderer_date_new (void)
+{
+	return GTK_CELL_RENDERER (g_object_new (gtk_cell_renderer_date_get_type (), NULL));
+}
+
+static void
+gtk_cell_renderer_date_set_property (GObject *object,
+                                     guint property_id,
+                                     const GValue *value,
+                                     GParamSpec *pspec)
+{
+	const gchar *str;
+
+	GtkCellRendererDate *cell = GTK_CELL_RENDERER_DATE (object);
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (cell);
+
+	switch (property_id)
+		{
+			case PROP_PACKED:
+				priv->packed = g_value_get_int64 (value);
+				break;
+
+			case PROP_JULIAN:
+				priv->packed = GTK_DATE_ENTRY_PACK (g_value_get_uint (value), 0);
+				break;
+
+			case PROP_FORMAT:
+				/* NULL, or a wrong one, for the locale's one */
+				str = _gtk_date_entry_intern_format (g_value_get_string (value));
+				if (str != priv->format)
+					{
+						priv->format = str;
+						gtk_cell_renderer_date_compile_format (cell);
+					}
+				break;
+
+			case PROP_SEPARATOR:
+				str = _gtk_date_entry_intern_separator (g_value_get_string (value));
+				if (str != priv->separator)
+					{
+						priv->separator = str;
+						gtk_cell_renderer_date_compile_format (cell);
+					}
+				break;
+
+			case PROP_TIME_SEPARATOR:
+				str = _gtk_date_entry_intern_separator (g_value_get_string (value));
+				if (str != NULL && str != priv->time_separator)
+					{
+						priv->time_separator = str;
+						gtk_cell_renderer_date_compile_format (cell);
+					}
+				break;
+
+			case PROP_TIME_VISIBLE:
+				if (priv->time_is_visible != g_value_get_boolean (value))
+					{
+						priv->time_is_visible = g_value_get_boolean (value);
+						gtk_cell_renderer_date_compile_format (cell);
+					}
+				break;
+
+			case PROP_TIME_WITH_SECONDS:
+				if (priv->time_with_seconds != g_value_get_boolean (value))
+					{
+						priv->time_with_seconds = g_value_get_boolean (value);
+						gtk_cell_renderer_date_compile_format (cell);
+					}
+				break;
+
+			case PROP_EDITABLE:
+				priv->editable = g_value_get_boolean (value);
+				g_object_set (object,
+				              "mode", priv->editable ? GTK_CELL_RENDERER_MODE_EDITABLE : GTK_CELL_RENDERER_MODE_INERT,
+				              NULL);
+				break;
+
+			default:
+				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+				break;
+		}
+}
+
+static void
+gtk_cell_renderer_date_get_property (GObject *object,
+                                     guint property_id,
+                                     GValue *value,
+                                     GParamSpec *pspec)
+{
+	GtkDateFormat *fmt;
+
+	GtkCellRendererDate *cell = GTK_CELL_RENDERER_DATE (object);
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (cell);
+
+	switch (property_id)
+		{
+			case PROP_PACKED:
+				g_value_set_int64 (value, priv->packed);
+				break;
+
+			case PROP_JULIAN:
+				g_value_set_uint (value, GTK_DATE_ENTRY_PACKED_JULIAN (priv->packed));
+				break;
+
+			case PROP_FORMAT:
+				/* the date's one: the compiled format has the time too */
+				if (priv->format != NULL)
+					{
+						g_value_set_string (value, priv->format);
+					}
+				else
+					{
+						fmt = _gtk_date_entry_ref_locale_format ();
+						g_value_set_string (value, gtk_date_format_get_format (fmt));
+						gtk_date_format_unref (fmt);
+					}
+				break;
+
+			case PROP_SEPARATOR:
+				if (priv->separator != NULL)
+					{
+						g_value_set_string (value, priv->separator);
+					}
+				else
+					{
+						fmt = _gtk_date_entry_ref_locale_format ();
+						g_value_set_string (value, gtk_date_format_get_separator (fmt));
+						gtk_date_format_unref (fmt);
+					}
+				break;
+
+			case PROP_TIME_SEPARATOR:
+				g_value_set_string (value, priv->time_separator);
+				break;
+
+			case PROP_TIME_VISIBLE:
+				g_value_set_boolean (value, priv->time_is_visible);
+				break;
+
+			case PROP_TIME_WITH_SECONDS:
+				g_value_set_boolean (value, priv->time_with_seconds);
+				break;
+
+			case PROP_EDITABLE:
+				g_value_set_boolean (value, priv->editable);
+				break;
+
+			default:
+				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+				break;
+		}
+}
+
+static void
+gtk_cell_renderer_date_get_preferred_width (GtkCellRenderer *cell,
+                                            GtkWidget *widget,
+                                            gint *minimum_size,
+                                            gint *natural_size)
+{
+	gint xpad;
+	gint width;
+	gint height;
+
+	gtk_cell_renderer_get_padding (cell, &xpad, NULL);
+	gtk_cell_renderer_date_get_size (GTK_CELL_RENDERER_DATE (cell), widget, &width, &height);
+
+	if (minimum_size != NULL)
+		{
+			*minimum_size = width + 2 * xpad;
+		}
+	if (natural_size != NULL)
+		{
+			*natural_size = width + 2 * xpad;
+		}
+}
+
+static void
+gtk_cell_renderer_date_get_preferred_height (GtkCellRenderer *cell,
+                                             GtkWidget *widget,
+                                             gint *minimum_size,
+                                             gint *natural_size)
+{
+	gint ypad;
+	gint width;
+	gint height;
+
+	gtk_cell_renderer_get_padding (cell, NULL, &ypad);
+	gtk_cell_renderer_date_get_size (GTK_CELL_RENDERER_DATE (cell), widget, &width, &height);
+
+	if (minimum_size != NULL)
+		{
+			*minimum_size = height + 2 * ypad;
+		}
+	if (natural_size != NULL)
+		{
+			*natural_size = height + 2 * ypad;
+		}
+}
+
+static void
+gtk_cell_renderer_date_render (GtkCellRenderer *cell,
+                               cairo_t *cr,
+                               GtkWidget *widget,
+                               const GdkRectangle *background_area,
+                               const GdkRectangle *cell_area,
+                               GtkCellRendererState flags)
+{
+	gchar text[64];
+	PangoLayout *layout;
+	gint xpad;
+	gint ypad;
+	gfloat xalign;
+	gfloat yalign;
+	gint width;
+	gint height;
+	gint x;
+	gint y;
+
+	GtkCellRendererDate *date = GTK_CELL_RENDERER_DATE (cell);
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (date);
+
+	if (priv->packed == 0
+	    || gtk_date_format_format (priv->compiled,
+	                               GTK_DATE_ENTRY_PACKED_JULIAN (priv->packed),
+	                               GTK_DATE_ENTRY_PACKED_SECONDS (priv->packed),
+	                               text, sizeof (text)) == 0)
+		{
+			return;
+		}
+
+	layout = gtk_cell_renderer_date_get_layout (date, widget);
+	if (strcmp (text, priv->text) != 0)
+		{
+			strcpy (priv->text, text);
+			pango_layout_set_text (layout, priv->text, -1);
+		}
+
+	gtk_cell_renderer_get_padding (cell, &xpad, &ypad);
+	gtk_cell_renderer_get_alignment (cell, &xalign, &yalign);
+	gtk_cell_renderer_date_get_size (date, widget, &width, &height);
+
+	if (gtk_widget_get_direction (widget) == GTK_TEXT_DIR_RTL)
+		{
+			xalign = 1.0 - xalign;
+		}
+	x = cell_area->x + xpad + MAX (0, (gint)(xalign * (cell_area->width - 2 * xpad - width)));
+	y = cell_area->y + ypad + MAX (0, (gint)(yalign * (cell_area->height - 2 * ypad - height)));
+
+	cairo_save (cr);
+	gdk_cairo_rectangle (cr, cell_area);
+	cairo_clip (cr);
+
+	gtk_render_layout (gtk_widget_get_style_context (widget), cr, x, y, layout);
+
+	cairo_restore (cr);
+}
+
+static GtkCellEditable
+*gtk_cell_renderer_date_start_editing (GtkCellRenderer *cell,
+                                       GdkEvent *event,
+                                       GtkWidget *widget,
+                                       const gchar *path,
+                                       const GdkRectangle *background_area,
+                                       const GdkRectangle *cell_area,
+                                       GtkCellRendererState flags)
+{
+	gchar format[4];
+	GtkDateEntry *editor;
+
+	GtkCellRendererDate *date = GTK_CELL_RENDERER_DATE (cell);
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (date);
+
+	if (!priv->editable)
+		{
+			return NULL;
+		}
+
+	/* the editor is kept when the view removes it, and used again */
+	if (priv->editor == NULL)
+		{
+			priv->editor = g_object_ref_sink (gtk_date_entry_new (NULL, NULL, TRUE));
+			g_signal_connect (priv->editor, "editing-done",
+			                  G_CALLBACK (editor_on_editing_done), date);
+		}
+	editor = GTK_DATE_ENTRY (priv->editor);
+
+	/* the date's part of the compiled format */
+	g_strlcpy (format, gtk_date_format_get_format (priv->compiled), sizeof (format));
+
+	gtk_date_entry_freeze_value_changed (editor);
+	gtk_date_entry_set_format (editor, format);
+	gtk_date_entry_set_separator (editor, gtk_date_format_get_separator (priv->compiled));
+	gtk_date_entry_set_time_separator (editor, priv->time_separator);
+	g_object_set (editor, "time-with-seconds", priv->time_with_seconds, NULL);
+	gtk_date_entry_set_time_visible (editor, priv->time_is_visible);
+	gtk_date_entry_set_julian_seconds (editor,
+	                                   GTK_DATE_ENTRY_PACKED_JULIAN (priv->packed),
+	                                   GTK_DATE_ENTRY_PACKED_SECONDS (priv->packed));
+	gtk_date_entry_thaw_value_changed (editor);
+
+	g_free (priv->path);
+	priv->path = g_strdup (path);
+
+	gtk_widget_show (priv->editor);
+
+	return GTK_CELL_EDITABLE (priv->editor);
+}
+
+static void
+editor_on_editing_done (GtkCellEditable *cell_editable,
+                        gpointer user_data)
+{
+	gboolean canceled;
+
+	GtkCellRendererDate *cell = (GtkCellRendererDate *)user_data;
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (cell);
+
+	g_object_get (cell_editable, "editing-canceled", &canceled, NULL);
+	gtk_cell_renderer_stop_editing (GTK_CELL_RENDERER (cell), canceled);
+	if (canceled || priv->path == NULL)
+		{
+			return;
+		}
+
+	g_signal_emit (cell, signals[EDITED], 0,
+	               priv->path,
+	               gtk_date_entry_get_packed (GTK_DATE_ENTRY (cell_editable)));
+}
+
+/* PRIVATE */
+static void
+gtk_cell_renderer_date_compile_format (GtkCellRendererDate *cell)
+{
+	gchar format[8];
+	GtkDateFormat *fmt;
+
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (cell);
+
+	if (!priv->constructed)
+		{
+			return;
+		}
+
+	fmt = NULL;
+	if (priv->format == NULL || priv->separator == NULL)
+		{
+			fmt = _gtk_date_entry_ref_locale_format ();
+		}
+
+	g_strlcpy (format,
+	           priv->format != NULL ? priv->format : gtk_date_format_get_format (fmt),
+	           sizeof (format));
+	if (priv->time_is_visible)
+		{
+			g_strlcat (format, priv->time_with_seconds ? "HMS" : "HM", sizeof (format));
+		}
+
+	if (priv->compiled != NULL)
+		{
+			gtk_date_format_unref (priv->compiled);
+		}
+	priv->compiled = gtk_date_format_new (format,
+	                                      priv->separator != NULL ? priv->separator : gtk_date_format_get_separator (fmt),
+	                                      priv->time_separator);
+
+	if (fmt != NULL)
+		{
+			gtk_date_format_unref (fmt);
+		}
+
+	priv->text[0] = '\0';
+	priv->size_valid = FALSE;
+}
+
+/* the layout of @widget's pango context; a new one if the context isn't
+ * the same */
+static PangoLayout
+*gtk_cell_renderer_date_get_layout (GtkCellRendererDate *cell,
+                                    GtkWidget *widget)
+{
+	PangoContext *context;
+
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (cell);
+
+	context = gtk_widget_get_pango_context (widget);
+	if (priv->layout == NULL
+	    || pango_layout_get_context (priv->layout) != context)
+		{
+			g_clear_object (&priv->layout);
+			priv->layout = pango_layout_new (context);
+			priv->layout_serial = pango_context_get_serial (context);
+			priv->text[0] = '\0';
+		}
+	else if (priv->layout_serial != pango_context_get_serial (context))
+		{
+			/* the font changed */
+			pango_layout_context_changed (priv->layout);
+			priv->layout_serial = pango_context_get_serial (context);
+		}
+
+	return priv->layout;
+}
+
+/* the size of every value's text, measured on the format's template while
+ * the format and the font don't change */
+static void
+gtk_cell_renderer_date_get_size (GtkCellRendererDate *cell,
+                                 GtkWidget *widget,
+                                 gint *width,
+                                 gint *height)
+{
+	PangoContext *context;
+	PangoLayout *layout;
+
+	GtkCellRendererDatePrivate *priv = GTK_CELL_RENDERER_DATE_GET_PRIVATE (cell);
+
+	context = gtk_widget_get_pango_context (widget);
+	if (!priv->size_valid
+	    || priv->size_context != context
+	    || priv->size_serial != pango_context_get_serial (context))
+		{
+			layout = pango_layout_new (context);
+			pango_layout_set_text (layout, gtk_date_format_get_template (priv->compiled), -1);
+			pango_layout_get_pixel_size (layout, &priv->size_width, &priv->size_height);
+			g_object_unref (layout);
+
+			priv->size_context = context;
+			priv->size_serial = pango_context_get_serial (context);
+			priv->size_valid = TRUE;
+		}
+
+	*width = priv->size_width;
+	*height = priv->size_height;
+}
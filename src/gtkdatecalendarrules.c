@@ -0,0 +1,669 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+	#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "gtkdatecalendarrules.h"
+
+/* the maximum number of days searched for a business day */
+#define GTK_DATE_CALENDAR_RULES_MAX_SEARCH (3 * 366)
+
+enum
+{
+	CHANGED,
+	LAST_SIGNAL
+};
+
+/* one year's days, as bits from the 1st of January: 384 bits cover 366 */
+typedef struct
+	{
+		/* the holidays of that year only */
+		guint32 holidays[12];
+		/* the closed days: weekends, yearly holidays and holidays */
+		guint32 closed[12];
+		/* the rules' generation the closed days are built for */
+		guint generation;
+	} GtkDateCalendarRulesYear;
+
+static void gtk_date_calendar_rules_class_init (GtkDateCalendarRulesClass *klass);
+static void gtk_date_calendar_rules_init (GtkDateCalendarRules *rules);
+static void gtk_date_calendar_rules_finalize (GObject *object);
+
+static GtkDateCalendarRulesYear *gtk_date_calendar_rules_get_year (GtkDateCalendarRules *rules,
+                                                                   GDateYear year);
+static gboolean gtk_date_calendar_rules_set_holiday (GtkDateCalendarRules *rules,
+                                                     guint32 julian);
+static void gtk_date_calendar_rules_changed (GtkDateCalendarRules *rules);
+
+static GObjectClass *parent_class = NULL;
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+#define GTK_DATE_CALENDAR_RULES_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GTK_TYPE_DATE_CALENDAR_RULES, GtkDateCalendarRulesPrivate))
+
+typedef struct _GtkDateCalendarRulesPrivate GtkDateCalendarRulesPrivate;
+struct _GtkDateCalendarRulesPrivate
+	{
+		/* a bit for every GDateWeekday */
+		guint8 weekend;
+
+		/* the yearly holidays, a bit for every day of every month */
+		guint32 yearly[12];
+
+		/* the years with a bitset: GtkDateCalendarRulesYear by year */
+		GHashTable *years;
+
+		/* bumped by every change of the weekend or of the yearly
+		 * holidays, so the years' closed days are built again on the
+		 * next lookup */
+		guint generation;
+	};
+
+G_DEFINE_TYPE (GtkDateCalendarRules, gtk_date_calendar_rules, G_TYPE_OBJECT)
+
+G_DEFINE_QUARK (gtk-date-calendar-rules-error-quark, gtk_date_calendar_rules_error)
+
+static void
+gtk_date_calendar_rules_class_init (GtkDateCalendarRulesClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	g_type_class_add_private (object_class, sizeof (GtkDateCalendarRulesPrivate));
+
+	parent_class = g_type_class_peek_parent (klass);
+
+	object_class->finalize = gtk_date_calendar_rules_finalize;
+
+	/**
+	 * GtkDateCalendarRules::changed:
+	 * @rules: the #GtkDateCalendarRules.
+	 *
+	 * Emitted when the weekend or the holidays change.
+	 */
+	signals[CHANGED] = g_signal_new ("changed",
+	                                 G_TYPE_FROM_CLASS (object_class),
+	                                 G_SIGNAL_RUN_LAST,
+	                                 G_STRUCT_OFFSET (GtkDateCalendarRulesClass, changed),
+	                                 NULL, NULL,
+	                                 g_cclosure_marshal_VOID__VOID,
+	                                 G_TYPE_NONE,
+	                                 0);
+}
+
+static void
+gtk_date_calendar_rules_init (GtkDateCalendarRules *rules)
+{
+	GtkDateCalendarRulesPrivate *priv = GTK_DATE_CALENDAR_RULES_GET_PRIVATE (rules);
+
+	priv->weekend = (1 << G_DATE_SATURDAY) | (1 << G_DATE_SUNDAY);
+	priv->years = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+	priv->generation = 1;
+}
+
+static void
+gtk_date_calendar_rules_finalize (GObject *object)
+{
+	GtkDateCalendarRulesPrivate *priv = GTK_DATE_CALENDAR_RULES_GET_PRIVATE (object);
+
+	g_hash_table_destroy (priv->years);
+
+	G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+/**
+ * gtk_date_calendar_rules_new:
+ *
+ * Creates the rules of the business days: by default Saturday and Sunday
+ * are the weekend, and there aren't holidays. The same rules can be set on
+ * many #GtkDateEntry.
+ *
+ * Returns: the newly created #GtkDateCalendarRules.
+ */
+GtkDateCalendarRules
+*gtk_date_calendar_rules_new (void)
+{
+	return GTK_DATE_CALENDAR_RULES (g_object_new (gtk_date_calendar_rules_get_type (), NULL));
+}
+
+/**
+ * gtk_date_calendar_rules_get_default:
+ *
+ * Returns: (transfer none): the rules shared by the whole application,
+ * created the first time.
+ */
+GtkDateCalendarRules
+*gtk_date_calendar_rules_get_default (void)
+{
+	static GtkDateCalendarRules *rules = NULL;
+
+	if (rules == NULL)
+		{
+			rules = gtk_date_calendar_rules_new ();
+		}
+
+	return rules;
+}
+
+/**
+ * gtk_date_calendar_rules_load_from_file:
+ * @rules: a #GtkDateCalendarRules.
+ * @filename: the file's name.
+ * @error: return location for a #GError, or NULL.
+ *
+ * Adds the rules read from @filename, a text file with one rule for every
+ * line; the empty lines and the ones starting with # are skipped:
+ * <itemizedlist>
+ * <listitem><para>weekend 6 7: the weekend's days, from 1 for Monday to 7
+ * for Sunday; it replaces the current weekend;</para></listitem>
+ * <listitem><para>12-25: a holiday every year, as MM-DD;</para></listitem>
+ * <listitem><para>2014-04-21: a holiday of one year only, as
+ * YYYY-MM-DD.</para></listitem>
+ * </itemizedlist>
+ *
+ * Returns: TRUE on success; on error @rules aren't changed.
+ */
+gboolean
+gtk_date_calendar_rules_load_from_file (GtkDateCalendarRules *rules,
+                                        const gchar *filename,
+                                        GError **error)
+{
+	gchar *contents;
+	gchar **lines;
+	gchar **weekdays;
+	gchar *line;
+	guint8 weekend;
+	guint32 yearly[12];
+	GArray *holidays;
+	GDate gdate;
+	guint32 julian;
+	gint year, month, day;
+	gint weekday;
+	gchar c;
+	guint i;
+	guint j;
+	gboolean ok;
+
+	g_return_val_if_fail (GTK_IS_DATE_CALENDAR_RULES (rules), FALSE);
+	g_return_val_if_fail (filename != NULL, FALSE);
+
+	GtkDateCalendarRulesPrivate *priv = GTK_DATE_CALENDAR_RULES_GET_PRIVATE (rules);
+
+	if (!g_file_get_contents (filename, &contents, NULL, error))
+		{
+			return FALSE;
+		}
+
+	/* the rules are collected first, and applied only if all are right */
+	weekend = priv->weekend;
+	memcpy (yearly, priv->yearly, sizeof (yearly));
+	holidays = g_array_new (FALSE, FALSE, sizeof (guint32));
+	g_date_clear (&gdate, 1);
+
+	ok = TRUE;
+	lines = g_strsplit (contents, "\n", -1);
+	for (i = 0; ok && lines[i] != NULL; i++)
+		{
+			line = g_strstrip (lines[i]);
+			if (line[0] == '\0' || line[0] == '#')
+				{
+					continue;
+				}
+
+			if (g_str_has_prefix (line, "weekend"))
+				{
+					weekend = 0;
+					weekdays = g_strsplit_set (line + strlen ("weekend"), " \t", -1);
+					for (j = 0; ok && weekdays[j] != NULL; j++)
+						{
+							if (weekdays[j][0] == '\0')
+								{
+									continue;
+								}
+							if (sscanf (weekdays[j], "%d%c", &weekday, &c) != 1
+							    || weekday < G_DATE_MONDAY || weekday > G_DATE_SUNDAY)
+								{
+									ok = FALSE;
+								}
+							else
+								{
+									weekend |= 1 << weekday;
+								}
+						}
+					g_strfreev (weekdays);
+				}
+			else if (sscanf (line, "%4d-%2d-%2d%c", &year, &month, &day, &c) == 3)
+				{
+					if (!g_date_valid_dmy (day, month, year))
+						{
+							ok = FALSE;
+						}
+					else
+						{
+							g_date_set_dmy (&gdate, day, month, year);
+							julian = g_date_get_julian (&gdate);
+							g_array_append_val (holidays, julian);
+						}
+				}
+			else if (sscanf (line, "%2d-%2d%c", &month, &day, &c) == 2
+			         && g_date_valid_dmy (day, month, 2000))
+				{
+					yearly[month - 1] |= 1 << (day - 1);
+				}
+			else
+				{
+					ok = FALSE;
+				}
+
+			if (!ok)
+				{
+					g_set_error (error, GTK_DATE_CALENDAR_RULES_ERROR, GTK_DATE_CALENDAR_RULES_ERROR_PARSE,
+					             "%s:%u: wrong rule \"%s\"", filename, i + 1, line);
+				}
+		}
+	g_strfreev (lines);
+	g_free (contents);
+
+	if (ok)
+		{
+			priv->weekend = weekend;
+			memcpy (priv->yearly, yearly, sizeof (yearly));
+			priv->generation++;
+
+			for (i = 0; i < holidays->len; i++)
+				{
+					gtk_date_calendar_rules_set_holiday (rules, g_array_index (holidays, guint32, i));
+				}
+
+			gtk_date_calendar_rules_changed (rules);
+		}
+
+	g_array_free (holidays, TRUE);
+
+	return ok;
+}
+
+/**
+ * gtk_date_calendar_rules_set_weekend_day:
+ * @rules: a #GtkDateCalendarRules.
+ * @weekday: a day of the week.
+ * @is_weekend: TRUE if @weekday isn't a business day.
+ *
+ * Changes the weekend: the years' bitsets are built again when they are
+ * looked up.
+ */
+void
+gtk_date_calendar_rules_set_weekend_day (GtkDateCalendarRules *rules,
+                                         GDateWeekday weekday,
+                                         gboolean is_weekend)
+{
+	guint8 weekend;
+
+	g_return_if_fail (GTK_IS_DATE_CALENDAR_RULES (rules));
+	g_return_if_fail (g_date_valid_weekday (weekday));
+
+	GtkDateCalendarRulesPrivate *priv = GTK_DATE_CALENDAR_RULES_GET_PRIVATE (rules);
+
+	if (is_weekend)
+		{
+			weekend = priv->weekend | (1 << weekday);
+		}
+	else
+		{
+			weekend = priv->weekend & ~(1 << weekday);
+		}
+
+	if (weekend == priv->weekend)
+		{
+			return;
+		}
+
+	priv->weekend = weekend;
+	priv->generation++;
+
+	gtk_date_calendar_rules_changed (rules);
+}
+
+/**
+ * gtk_date_calendar_rules_is_weekend_day:
+ * @rules: a #GtkDateCalendarRules.
+ * @weekday: a day of the week.
+ *
+ * Returns: TRUE if @weekday isn't a business day.
+ */
+gboolean
+gtk_date_calendar_rules_is_weekend_day (GtkDateCalendarRules *rules,
+                                        GDateWeekday weekday)
+{
+	g_return_val_if_fail (GTK_IS_DATE_CALENDAR_RULES (rules), FALSE);
+	g_return_val_if_fail (g_date_valid_weekday (weekday), FALSE);
+
+	GtkDateCalendarRulesPrivate *priv = GTK_DATE_CALENDAR_RULES_GET_PRIVATE (rules);
+
+	return (priv->weekend & (1 << weekday)) != 0;
+}
+
+/**
+ * gtk_date_calendar_rules_add_holiday:
+ * @rules: a #GtkDateCalendarRules.
+ * @julian: the holiday, as a GDate's julian day.
+ *
+ * Adds a holiday of one year only.
+ */
+void
+gtk_date_calendar_rules_add_holiday (GtkDateCalendarRules *rules,
+                                     guint32 julian)
+{
+	g_return_if_fail (GTK_IS_DATE_CALENDAR_RULES (rules));
+	g_return_if_fail (g_date_valid_julian (julian));
+
+	if (gtk_date_calendar_rules_set_holiday (rules, julian))
+		{
+			gtk_date_calendar_rules_changed (rules);
+		}
+}
+
+/**
+ * gtk_date_calendar_rules_add_yearly_holiday:
+ * @rules: a #GtkDateCalendarRules.
+ * @month: the holiday's month.
+ * @day: the holiday's day of the month.
+ *
+ * Adds a holiday of every year; the 29th of February is a holiday only in
+ * the leap years.
+ */
+void
+gtk_date_calendar_rules_add_yearly_holiday (GtkDateCalendarRules *rules,
+                                            GDateMonth month,
+                                            GDateDay day)
+{
+	g_return_if_fail (GTK_IS_DATE_CALENDAR_RULES (rules));
+	g_return_if_fail (g_date_valid_dmy (day, month, 2000));
+
+	GtkDateCalendarRulesPrivate *priv = GTK_DATE_CALENDAR_RULES_GET_PRIVATE (rules);
+
+	if (priv->yearly[month - 1] & (1u << (day - 1)))
+		{
+			return;
+		}
+
+	priv->yearly[month - 1] |= 1u << (day - 1);
+	priv->generation++;
+
+	gtk_date_calendar_rules_changed (rules);
+}
+
+/**
+ * gtk_date_calendar_rules_clear:
+ * @rules: a #GtkDateCalendarRules.
+ *
+ * Removes all the holidays; the weekend is kept.
+ */
+void
+gtk_date_calendar_rules_clear (GtkDateCalendarRules *rules)
+{
+	g_return_if_fail (GTK_IS_DATE_CALENDAR_RULES (rules));
+
+	GtkDateCalendarRulesPrivate *priv = GTK_DATE_CALENDAR_RULES_GET_PRIVATE (rules);
+
+	memset (priv->yearly, 0, sizeof (priv->yearly));
+	g_hash_table_remove_all (priv->years);
+	priv->generation++;
+
+	gtk_date_calendar_rules_changed (rules);
+}
+
+/**
+ * gtk_date_calendar_rules_is_business_day:
+ * @rules: a #GtkDateCalendarRules.
+ * @julian: a GDate's julian day.
+ *
+ * The lookup is one bit of the year's bitset, whatever the number of
+ * years with holidays.
+ *
+ * Returns: TRUE if @julian isn't a weekend's day nor a holiday.
+ */
+gboolean
+gtk_date_calendar_rules_is_business_day (GtkDateCalendarRules *rules,
+                                         guint32 julian)
+{
+	GtkDateCalendarRulesYear *year;
+	GDate gdate;
+	guint bit;
+
+	g_return_val_if_fail (GTK_IS_DATE_CALENDAR_RULES (rules), FALSE);
+	g_return_val_if_fail (g_date_valid_julian (julian), FALSE);
+
+	g_date_clear (&gdate, 1);
+	g_date_set_julian (&gdate, julian);
+
+	year = gtk_date_calendar_rules_get_year (rules, g_date_get_year (&gdate));
+	bit = g_date_get_day_of_year (&gdate) - 1;
+
+	return (year->closed[bit >> 5] & (1u << (bit & 31))) == 0;
+}
+
+/**
+ * gtk_date_calendar_rules_next_business_day:
+ * @rules: a #GtkDateCalendarRules.
+ * @julian: a GDate's julian day.
+ *
+ * The search skips the closed days 32 at a time.
+ *
+ * Returns: the first business day after @julian; 0 if there isn't one in
+ * the next three years.
+ */
+guint32
+gtk_date_calendar_rules_next_business_day (GtkDateCalendarRules *rules,
+                                           guint32 julian)
+{
+	GtkDateCalendarRulesYear *year;
+	GDate gdate;
+	guint days;
+	guint bit;
+	guint searched;
+	guint32 open;
+
+	g_return_val_if_fail (GTK_IS_DATE_CALENDAR_RULES (rules), 0);
+	g_return_val_if_fail (g_date_valid_julian (julian), 0);
+
+	g_date_clear (&gdate, 1);
+	g_date_set_julian (&gdate, julian + 1);
+
+	/* the bit of julian + 1 in its year */
+	year = gtk_date_calendar_rules_get_year (rules, g_date_get_year (&gdate));
+	days = g_date_is_leap_year (g_date_get_year (&gdate)) ? 366 : 365;
+	bit = g_date_get_day_of_year (&gdate) - 1;
+	julian++;
+
+	for (searched = 0; searched < GTK_DATE_CALENDAR_RULES_MAX_SEARCH; )
+		{
+			/* the open days of the word from the bit on, in the year */
+			open = ~year->closed[bit >> 5] >> (bit & 31);
+			if ((bit | 31) >= days)
+				{
+					open &= (1u << (days - bit)) - 1;
+				}
+
+			if (open != 0)
+				{
+					return julian + g_bit_nth_lsf (open, -1);
+				}
+
+			/* the next word, or the next year */
+			searched += 32 - (bit & 31);
+			julian += 32 - (bit & 31);
+			bit = (bit | 31) + 1;
+			if (bit >= days)
+				{
+					julian -= bit - days;
+					g_date_set_julian (&gdate, julian);
+					year = gtk_date_calendar_rules_get_year (rules, g_date_get_year (&gdate));
+					days = g_date_is_leap_year (g_date_get_year (&gdate)) ? 366 : 365;
+					bit = 0;
+				}
+		}
+
+	return 0;
+}
+
+/**
+ * gtk_date_calendar_rules_get_business_days:
+ * @rules: a #GtkDateCalendarRules.
+ * @year: a year.
+ * @month: a month of @year.
+ *
+ * Returns: the business days of @month: the bit 0 for the 1st, the bit 1
+ * for the 2nd, and so on.
+ */
+guint32
+gtk_date_calendar_rules_get_business_days (GtkDateCalendarRules *rules,
+                                           GDateYear year,
+                                           GDateMonth month)
+{
+	GtkDateCalendarRulesYear *y;
+	GDate gdate;
+	guint bit;
+	guint days;
+	guint64 closed;
+
+	g_return_val_if_fail (GTK_IS_DATE_CALENDAR_RULES (rules), 0);
+	g_return_val_if_fail (g_date_valid_dmy (1, month, year), 0);
+
+	g_date_clear (&gdate, 1);
+	g_date_set_dmy (&gdate, 1, month, year);
+
+	y = gtk_date_calendar_rules_get_year (rules, year);
+	bit = g_date_get_day_of_year (&gdate) - 1;
+	days = g_date_get_days_in_month (month, year);
+
+	/* a month is at most in two words; December starts in the 11th */
+	closed = y->closed[bit >> 5];
+	if ((bit >> 5) < 11)
+		{
+			closed |= (guint64)y->closed[(bit >> 5) + 1] << 32;
+		}
+	closed >>= bit & 31;
+
+	return ~(guint32)closed & (guint32)(((guint64)1 << days) - 1);
+}
+
+/* PRIVATE */
+/* the year's bitsets, built when missing or when the rules changed */
+static GtkDateCalendarRulesYear
+*gtk_date_calendar_rules_get_year (GtkDateCalendarRules *rules,
+                                   GDateYear year)
+{
+	GtkDateCalendarRulesYear *y;
+	GDate gdate;
+	GDateWeekday weekday;
+	GDateMonth month;
+	guint bit;
+	guint days;
+	guint day;
+	guint i;
+
+	GtkDateCalendarRulesPrivate *priv = GTK_DATE_CALENDAR_RULES_GET_PRIVATE (rules);
+
+	y = g_hash_table_lookup (priv->years, GUINT_TO_POINTER (year));
+	if (y == NULL)
+		{
+			y = g_new0 (GtkDateCalendarRulesYear, 1);
+			g_hash_table_insert (priv->years, GUINT_TO_POINTER (year), y);
+		}
+	else if (y->generation == priv->generation)
+		{
+			return y;
+		}
+
+	memcpy (y->closed, y->holidays, sizeof (y->closed));
+
+	/* the weekend: the weekdays follow each other from the 1st of
+	 * January */
+	g_date_clear (&gdate, 1);
+	g_date_set_dmy (&gdate, 1, G_DATE_JANUARY, year);
+	weekday = g_date_get_weekday (&gdate);
+	days = g_date_is_leap_year (year) ? 366 : 365;
+	for (i = 0; i < days; i++)
+		{
+			if (priv->weekend & (1 << weekday))
+				{
+					y->closed[i >> 5] |= 1u << (i & 31);
+				}
+			weekday = weekday == G_DATE_SUNDAY ? G_DATE_MONDAY : weekday + 1;
+		}
+
+	/* the yearly holidays */
+	bit = 0;
+	for (month = G_DATE_JANUARY; month <= G_DATE_DECEMBER; month++)
+		{
+			days = g_date_get_days_in_month (month, year);
+			for (day = 0; day < days; day++)
+				{
+					if (priv->yearly[month - 1] & (1u << day))
+						{
+							y->closed[(bit + day) >> 5] |= 1u << ((bit + day) & 31);
+						}
+				}
+			bit += days;
+		}
+
+	y->generation = priv->generation;
+
+	return y;
+}
+
+/* a holiday of one year doesn't need the year to be built again; returns
+ * FALSE if it was already there */
+static gboolean
+gtk_date_calendar_rules_set_holiday (GtkDateCalendarRules *rules,
+                                     guint32 julian)
+{
+	GtkDateCalendarRulesYear *year;
+	GDate gdate;
+	guint bit;
+
+	g_date_clear (&gdate, 1);
+	g_date_set_julian (&gdate, julian);
+
+	year = gtk_date_calendar_rules_get_year (rules, g_date_get_year (&gdate));
+	bit = g_date_get_day_of_year (&gdate) - 1;
+	if (year->holidays[bit >> 5] & (1u << (bit & 31)))
+		{
+			return FALSE;
+		}
+
+	year->holidays[bit >> 5] |= 1u << (bit & 31);
+	year->closed[bit >> 5] |= 1u << (bit & 31);
+
+	return TRUE;
+}
+
+static void
+gtk_date_calendar_rules_changed (GtkDateCalendarRules *rules)
+{
+	g_signal_emit (rules, signals[CHANGED], 0);
+}
@@ -0,0 +1,97 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+
+#ifndef __GTK_DATE_CALENDAR_RULES_H__
+#define __GTK_DATE_CALENDAR_RULES_H__
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+
+#define GTK_TYPE_DATE_CALENDAR_RULES           (gtk_date_calendar_rules_get_type ())
+#define GTK_DATE_CALENDAR_RULES(obj)           (G_TYPE_CHECK_INSTANCE_CAST ((obj), GTK_TYPE_DATE_CALENDAR_RULES, GtkDateCalendarRules))
+#define GTK_DATE_CALENDAR_RULES_CLASS(klass)   (G_TYPE_CHECK_CLASS_CAST ((klass), GTK_TYPE_DATE_CALENDAR_RULES, GtkDateCalendarRulesClass))
+#define GTK_IS_DATE_CALENDAR_RULES(obj)        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GTK_TYPE_DATE_CALENDAR_RULES))
+#define GTK_IS_DATE_CALENDAR_RULES_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), GTK_TYPE_DATE_CALENDAR_RULES))
+#define GTK_DATE_CALENDAR_RULES_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), GTK_TYPE_DATE_CALENDAR_RULES, GtkDateCalendarRulesClass))
+
+#define GTK_DATE_CALENDAR_RULES_ERROR (gtk_date_calendar_rules_error_quark ())
+
+typedef enum
+{
+	GTK_DATE_CALENDAR_RULES_ERROR_PARSE
+} GtkDateCalendarRulesError;
+
+
+typedef struct _GtkDateCalendarRules GtkDateCalendarRules;
+typedef struct _GtkDateCalendarRulesClass GtkDateCalendarRulesClass;
+
+
+struct _GtkDateCalendarRules
+{
+	GObject parent;
+};
+
+struct _GtkDateCalendarRulesClass
+{
+	GObjectClass parent_class;
+
+	void (*changed) (GtkDateCalendarRules *rules);
+};
+
+
+GType gtk_date_calendar_rules_get_type (void) G_GNUC_CONST;
+GQuark gtk_date_calendar_rules_error_quark (void);
+
+GtkDateCalendarRules *gtk_date_calendar_rules_new (void);
+GtkDateCalendarRules *gtk_date_calendar_rules_get_default (void);
+
+gboolean gtk_date_calendar_rules_load_from_file (GtkDateCalendarRules *rules,
+                                                 const gchar *filename,
+                                                 GError **error);
+
+void gtk_date_calendar_rules_set_weekend_day (GtkDateCalendarRules *rules,
+                                              GDateWeekday weekday,
+                                              gboolean is_weekend);
+gboolean gtk_date_calendar_rules_is_weekend_day (GtkDateCalendarRules *rules,
+                                                 GDateWeekday weekday);
+
+void gtk_date_calendar_rules_add_holiday (GtkDateCalendarRules *rules,
+                                          guint32 julian);
+void gtk_date_calendar_rules_add_yearly_holiday (GtkDateCalendarRules *rules,
+                                                 GDateMonth month,
+                                                 GDateDay day);
+void gtk_date_calendar_rules_clear (GtkDateCalendarRules *rules);
+
+gboolean gtk_date_calendar_rules_is_business_day (GtkDateCalendarRules *rules,
+                                                  guint32 julian);
+guint32 gtk_date_calendar_rules_next_business_day (GtkDateCalendarRules *rules,
+                                                   guint32 julian);
+guint32 gtk_date_calendar_rules_get_business_days (GtkDateCalendarRules *rules,
+                                                   GDateYear year,
+                                                   GDateMonth month);
+
+
+G_END_DECLS
+
+#endif /* __GTK_DATE_CALENDAR_RULES_H__ */
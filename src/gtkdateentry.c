@@ -39,6 +39,7 @@
 #include <libgdaex/queryeditor_widget_interface.h>
 
 #include "gtkdateentry.h"
+#include "gtkdateentryprivate.h"
 
 enum
 {
@@ -50,13 +51,38 @@ enum
 	PROP_CALENDAR_BUTTON_VISIBLE,
 	PROP_DATE_VISIBLE,
 	PROP_TIME_VISIBLE,
-	PROP_TIME_WITH_SECONDS
+	PROP_TIME_WITH_SECONDS,
+	PROP_JULIAN,
+	PROP_SECONDS,
+	PROP_UNIX_USEC,
+	PROP_TIMEZONE,
+	PROP_UTC,
+	PROP_VALID,
+	PROP_COMPLETE,
+	PROP_MIN_DATE,
+	PROP_MAX_DATE,
+	PROP_CALENDAR_RULES,
+	PROP_EDITING_CANCELED
 };
 
+enum
+{
+	VALUE_CHANGED,
+	LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
 static void gtk_date_entry_class_init (GtkDateEntryClass *klass);
 static void gtk_date_entry_init (GtkDateEntry *date);
+static void gtk_date_entry_constructed (GObject *object);
+static void gtk_date_entry_dispose (GObject *object);
+static void gtk_date_entry_finalize (GObject *object);
 
 static void gtk_date_entry_gdaex_query_editor_iwidget_interface_init (GdaExQueryEditorIWidgetIface *iface);
+static void gtk_date_entry_cell_editable_interface_init (GtkCellEditableIface *iface);
+static void gtk_date_entry_start_editing (GtkCellEditable *cell_editable,
+                                         GdkEvent *event);
 
 static void gtk_date_entry_get_preferred_height (GtkWidget *widget,
                                                  gint *minimum_height,
@@ -66,10 +92,61 @@ static void gtk_date_entry_get_preferred_width (GtkWidget *widget,
                                                 gint *natural_width);
 static void gtk_date_entry_size_allocate (GtkWidget *widget,
                                      GtkAllocation *allocation);
-
+static void gtk_date_entry_parent_set (GtkWidget *widget,
+                                       GtkWidget *previous_parent);
+
+static void gtk_date_entry_compile_format (GtkDateEntry *date);
+static GtkDateFormat *gtk_date_entry_get_strf_format (GtkDateEntry *date,
+                                                      const gchar *format,
+                                                      const gchar *separator,
+                                                      const gchar *time_separator);
+static GTimeZone *gtk_date_entry_get_time_zone (GtkDateEntry *date);
+static GTimeZone *gtk_date_entry_get_conversion_zone (GtkDateEntry *date);
+static gchar *gtk_date_entry_get_buffer (GtkDateEntry *date,
+                                         gsize len);
+static gsize gtk_date_entry_write (GtkDateEntry *date,
+                                   const GtkDateFormat *fmt,
+                                   gchar *buf,
+                                   gsize len);
+static void gtk_date_entry_build_popup (void);
+static void gtk_date_entry_destroy_popup (void);
 static void gtk_date_entry_change_mask (GtkDateEntry *date);
+static void gtk_date_entry_set_time_seconds (GtkDateEntry *date,
+                                             gint32 seconds);
+static void gtk_date_entry_sync_spins (GtkDateEntry *date);
+static void gtk_date_entry_emit_value_changed (GtkDateEntry *date);
+static gboolean gtk_date_entry_date_is (GtkDateEntry *date,
+                                        gint32 julian);
+static void gtk_date_entry_apply_time_visible (GtkDateEntry *date);
+static void gtk_date_entry_mark_segments (GtkDateEntry *date,
+                                          gint start_pos,
+                                          gint end_pos);
+static void gtk_date_entry_validate_segment (GtkDateEntry *date,
+                                             const gchar *text,
+                                             guint segment);
+static void gtk_date_entry_validate (GtkDateEntry *date);
+static gint32 gtk_date_entry_clamp_julian (GtkDateEntry *date,
+                                           gint32 julian);
+static void gtk_date_entry_set_bounds (GtkDateEntry *date,
+                                       guint32 min_julian,
+                                       guint32 max_julian);
+static gboolean gtk_date_entry_is_allowed (GtkDateEntry *date,
+                                           guint32 julian);
+static void gtk_date_entry_revalidate (GtkDateEntry *date);
+static void gtk_date_entry_mark_calendar (void);
+static void gtk_date_entry_finish_editing (GtkDateEntry *date,
+                                          gboolean canceled);
+static gboolean gtk_date_entry_check_focus (gpointer user_data);
+static void gtk_date_entry_build_time (GtkDateEntry *date);
+static void gtk_date_entry_show_time (GtkDateEntry *date);
+static void gtk_date_entry_set_date_julian (GtkDateEntry *date,
+                                            gint32 julian);
+static void gtk_date_entry_set_value_julian (GtkDateEntry *date,
+                                             gint32 julian,
+                                             gint32 seconds);
 
 static void hide_popup (GtkWidget *date);
+static gboolean popup_on_timeout (gpointer user_data);
 static gboolean popup_grab_on_window (GdkWindow *window,
                                       guint32 activate_time);
 static gint delete_popup (GtkWidget *widget,
@@ -86,6 +163,31 @@ static void calendar_on_day_selected (GtkCalendar *calendar,
                                       gpointer user_data);
 static void calendar_on_day_selected_double_click (GtkCalendar *calendar,
                                                    gpointer user_data);
+static void calendar_on_month_changed (GtkCalendar *calendar,
+                                       gpointer user_data);
+static void day_on_insert_text (GtkEditable *editable,
+                                gchar *new_text,
+                                gint new_text_length,
+                                gpointer position,
+                                gpointer user_data);
+static void day_on_delete_text (GtkEditable *editable,
+                                gint start_pos,
+                                gint end_pos,
+                                gpointer user_data);
+static void day_on_changed (GtkEditable *editable,
+                            gpointer user_data);
+static void rules_on_changed (GtkDateCalendarRules *rules,
+                              gpointer user_data);
+static void part_on_activate (GtkEntry *entry,
+                             gpointer user_data);
+static gboolean part_on_key_press_event (GtkWidget *widget,
+                                         GdkEventKey *event,
+                                         gpointer user_data);
+static gboolean part_on_focus_out_event (GtkWidget *widget,
+                                         GdkEventFocus *event,
+                                         gpointer user_data);
+static void spn_time_on_value_changed (GtkSpinButton *spin_button,
+                                       gpointer user_data);
 
 static void gtk_date_entry_set_property (GObject *object,
                                            guint property_id,
@@ -96,8 +198,8 @@ static void gtk_date_entry_get_property (GObject *object,
                                            GValue *value,
                                            GParamSpec *pspec);
 
-static gchar *gtk_date_entry_get_separator_from_locale ();
-static gchar *gtk_date_entry_get_format_from_locale ();
+static void gtk_date_entry_read_locale (gchar *format,
+                                        gchar *separator);
 
 static const gchar *gtk_date_entry_get_value (GdaExQueryEditorIWidget *iwidget);
 static const gchar *gtk_date_entry_get_value_sql (GdaExQueryEditorIWidget *iwidget);
@@ -108,14 +210,25 @@ static GtkWidgetClass *parent_class = NULL;
 
 #define GTK_DATE_ENTRY_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GTK_TYPE_DATE_ENTRY, GtkDateEntryPrivate))
 
+/* counts the setters' calls that changed something and the ones that
+ * found the same state, only in a debug build */
+#ifdef GTK_DATE_ENTRY_DEBUG
+static guint updates_applied = 0;
+static guint updates_skipped = 0;
+#define GTK_DATE_ENTRY_COUNT(counter) ((counter)++)
+#else
+#define GTK_DATE_ENTRY_COUNT(counter)
+#endif
+
+/* seconds the closed calendar's popup is kept before being destroyed */
+#define GTK_DATE_ENTRY_POPUP_TIMEOUT 30
+
 typedef struct _GtkDateEntryPrivate GtkDateEntryPrivate;
 struct _GtkDateEntryPrivate
 	{
 		GtkWidget *hbox;
 		GtkWidget *day;
 		GtkWidget *btnCalendar;
-		GtkWidget *wCalendar;
-		GtkWidget *calendar;
 
 		GtkWidget *spnHours;
 		GtkWidget *lblMinutes;
@@ -123,19 +236,90 @@ struct _GtkDateEntryPrivate
 		GtkWidget *lblSeconds;
 		GtkWidget *spnSeconds;
 
-		gchar *separator;
-		gchar *time_separator;
-		gchar *format;
+		const gchar *separator;
+		const gchar *time_separator;
+		const gchar *format;
 		gboolean editable_with_calendar;
 
+		GtkDateFormat *compiled;
+		GtkDateFormat *strf_format;
+
+		/* returned by get_text, get_strf and get_sql */
+		gchar *buffer;
+		gsize buffer_len;
+
 		gboolean date_is_visible;
 		gboolean time_is_visible;
 		gboolean time_with_seconds;
+
+		/* FALSE while the construct properties are set */
+		gboolean constructed;
+
+		GtkDateEntryValue value;
+
+		/* TRUE if the date's text was cleared and not edited since */
+		gboolean date_cleared;
+
+		/* the date's segments, in the order of the format: their values,
+		 * and the bitmasks of the complete ones, of the ones out of range
+		 * and of the ones edited since the last validation */
+		gint seg_values[3];
+		guint8 seg_complete;
+		guint8 seg_error;
+		guint8 seg_dirty;
+
+		/* TRUE if all the date's segments are filled */
+		gboolean complete;
+
+		/* the allowed dates, as julian days; 0 for no bound */
+		guint32 min_julian;
+		guint32 max_julian;
+
+		/* the business days, maybe shared with other entries */
+		GtkDateCalendarRules *rules;
+		gulong rules_changed_id;
+
+		/* TRUE between gtk_cell_editable_start_editing() and
+		 * "editing-done"; the idle source that checks where the focus
+		 * went when a part lost it */
+		gboolean editing;
+		gboolean editing_canceled;
+		guint focus_check_id;
+
+		/* the value of the last "value-changed", and the number of
+		 * gtk_date_entry_freeze_value_changed() not thawed yet */
+		gint64 packed;
+		guint freeze_count;
+
+		/* NULL for the local time zone */
+		GTimeZone *tz;
+		gboolean utc;
 	};
 
+/* one calendar's popup for all the entries, built when it is opened the
+ * first time: only one can be open at a time, because of the grabs, and
+ * its callbacks act on the owner */
+static struct
+	{
+		GtkWidget *window;
+		GtkWidget *calendar;
+		GtkDateEntry *owner;
+		guint timeout_id;
+	} popup = { NULL, NULL, NULL, 0 };
+
+/* the locale's format, shared by all the entries */
+G_LOCK_DEFINE_STATIC (locale_format);
+static GtkDateFormat *locale_format = NULL;
+
+/* the local time zone, resolved on first use and again only after
+ * gtk_date_entry_time_zone_changed () */
+static GTimeZone *local_tz = NULL;
+
 G_DEFINE_TYPE_WITH_CODE (GtkDateEntry, gtk_date_entry, GTK_TYPE_BIN,
                          G_IMPLEMENT_INTERFACE (GDAEX_QUERY_EDITOR_TYPE_IWIDGET,
-                                                gtk_date_entry_gdaex_query_editor_iwidget_interface_init));
+                                                gtk_date_entry_gdaex_query_editor_iwidget_interface_init)
+                         G_IMPLEMENT_INTERFACE (GTK_TYPE_CELL_EDITABLE,
+                                                gtk_date_entry_cell_editable_interface_init));
 
 static void
 gtk_date_entry_class_init (GtkDateEntryClass *klass)
@@ -151,31 +335,35 @@ gtk_date_entry_class_init (GtkDateEntryClass *klass)
 
 	object_class->set_property = gtk_date_entry_set_property;
 	object_class->get_property = gtk_date_entry_get_property;
+	object_class->constructed = gtk_date_entry_constructed;
+	object_class->dispose = gtk_date_entry_dispose;
+	object_class->finalize = gtk_date_entry_finalize;
 
 	widget_class->get_preferred_height = gtk_date_entry_get_preferred_height;
 	widget_class->get_preferred_width = gtk_date_entry_get_preferred_width;
 	widget_class->size_allocate = gtk_date_entry_size_allocate;
+	widget_class->parent_set = gtk_date_entry_parent_set;
 
 	g_object_class_install_property (object_class, PROP_SEPARATOR,
 	                                 g_param_spec_string ("separator",
 	                                                      "The separator",
-	                                                      "The separator between day, month and year.",
-	                                                      "",
-	                                                      G_PARAM_READWRITE));
+	                                                      "The separator between day, month and year; NULL for the locale's one.",
+	                                                      NULL,
+	                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
 
 	g_object_class_install_property (object_class, PROP_TIME_SEPARATOR,
 	                                 g_param_spec_string ("time-separator",
 	                                                      "The time separator",
 	                                                      "The separator between hours, minutes and seconds.",
-	                                                      "",
+	                                                      ":",
 	                                                      G_PARAM_READWRITE));
 
 	g_object_class_install_property (object_class, PROP_FORMAT,
 	                                 g_param_spec_string ("format",
 	                                                      "The date's format",
-	                                                      "The date's format.",
-	                                                      "",
-	                                                      G_PARAM_READWRITE));
+	                                                      "The date's format; NULL for the locale's one.",
+	                                                      NULL,
+	                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
 
 	g_object_class_install_property (object_class, PROP_EDITABLE_WITH_CALENDAR,
 	                                 g_param_spec_boolean ("editable-from-calendar",
@@ -190,7 +378,7 @@ gtk_date_entry_class_init (GtkDateEntryClass *klass)
 	                                                       "TRUE to show the calendar's button",
 	                                                       "Determines if the calendar's button is visible or not.",
 	                                                       TRUE,
-	                                                       G_PARAM_READWRITE));
+	                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
 
 	g_object_class_install_property (object_class, PROP_DATE_VISIBLE,
 	                                 g_param_spec_boolean ("date-visible",
@@ -204,14 +392,162 @@ gtk_date_entry_class_init (GtkDateEntryClass *klass)
 	                                                       "TRUE to show the time part",
 	                                                       "Determines if the time part of the widget is visible or not.",
 	                                                       TRUE,
-	                                                       G_PARAM_READWRITE));
+	                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
 
 	g_object_class_install_property (object_class, PROP_TIME_WITH_SECONDS,
 	                                 g_param_spec_boolean ("time-with-seconds",
 	                                                       "TRUE to show the seconds in time part",
 	                                                       "Determines if the seconds in the time part of the widget are visible or not.",
 	                                                       TRUE,
+	                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+	g_object_class_install_property (object_class, PROP_JULIAN,
+	                                 g_param_spec_uint ("julian",
+	                                                    "The date as a julian day",
+	                                                    "The date as a GDate's julian day; 0 if it isn't valid.",
+	                                                    0,
+	                                                    G_MAXINT32,
+	                                                    0,
+	                                                    G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_SECONDS,
+	                                 g_param_spec_int ("seconds",
+	                                                   "The seconds of the day",
+	                                                   "The time as seconds since midnight.",
+	                                                   0,
+	                                                   86399,
+	                                                   0,
+	                                                   G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_UNIX_USEC,
+	                                 g_param_spec_int64 ("unix-usec",
+	                                                     "The unix time",
+	                                                     "The date and time as microseconds since 1970-01-01 00:00:00 UTC;"
+	                                                     " G_MININT64 if it isn't valid.",
+	                                                     G_MININT64,
+	                                                     G_MAXINT64,
+	                                                     G_MININT64,
+	                                                     G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_TIMEZONE,
+	                                 g_param_spec_boxed ("timezone",
+	                                                     "The time zone",
+	                                                     "The time zone of the shown date and time; NULL for the local one.",
+	                                                     G_TYPE_TIME_ZONE,
+	                                                     G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_UTC,
+	                                 g_param_spec_boolean ("utc",
+	                                                       "TRUE to show UTC",
+	                                                       "Determines if the shown date and time are in UTC.",
+	                                                       FALSE,
 	                                                       G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_VALID,
+	                                 g_param_spec_boolean ("valid",
+	                                                       "TRUE if the date is valid",
+	                                                       "Determines if the date's segments make a valid date.",
+	                                                       FALSE,
+	                                                       G_PARAM_READABLE));
+
+	g_object_class_install_property (object_class, PROP_COMPLETE,
+	                                 g_param_spec_boolean ("complete",
+	                                                       "TRUE if the date is complete",
+	                                                       "Determines if all the date's segments are filled, even if the date isn't valid.",
+	                                                       FALSE,
+	                                                       G_PARAM_READABLE));
+
+	g_object_class_install_property (object_class, PROP_MIN_DATE,
+	                                 g_param_spec_uint ("min-date",
+	                                                    "The first allowed date",
+	                                                    "The first allowed date as a GDate's julian day; 0 for no bound.",
+	                                                    0,
+	                                                    G_MAXINT32,
+	                                                    0,
+	                                                    G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_MAX_DATE,
+	                                 g_param_spec_uint ("max-date",
+	                                                    "The last allowed date",
+	                                                    "The last allowed date as a GDate's julian day; 0 for no bound.",
+	                                                    0,
+	                                                    G_MAXINT32,
+	                                                    0,
+	                                                    G_PARAM_READWRITE));
+
+	g_object_class_override_property (object_class, PROP_EDITING_CANCELED, "editing-canceled");
+
+	g_object_class_install_property (object_class, PROP_CALENDAR_RULES,
+	                                 g_param_spec_object ("calendar-rules",
+	                                                      "The business days",
+	                                                      "The rules of the business days; NULL if all days are allowed.",
+	                                                      GTK_TYPE_DATE_CALENDAR_RULES,
+	                                                      G_PARAM_READWRITE));
+
+	/**
+	 * GtkDateEntry::value-changed:
+	 * @date: the #GtkDateEntry.
+	 * @packed: the new value, as returned by gtk_date_entry_get_packed().
+	 *
+	 * Emitted once for every change of the value, by the user or by the
+	 * setters, and not for the intermediate states of the parts; between
+	 * gtk_date_entry_freeze_value_changed() and
+	 * gtk_date_entry_thaw_value_changed() at most once, when thawing.
+	 */
+	/* no class handler: the installed class struct keeps its size */
+	signals[VALUE_CHANGED] = g_signal_new ("value-changed",
+	                                       G_TYPE_FROM_CLASS (object_class),
+	                                       G_SIGNAL_RUN_LAST,
+	                                       0,
+	                                       NULL, NULL,
+	                                       g_cclosure_marshal_generic,
+	                                       G_TYPE_NONE,
+	                                       1, G_TYPE_INT64);
+}
+
+/* the buffer returned by get_text, get_strf and get_sql; it grows only */
+static gchar
+*gtk_date_entry_get_buffer (GtkDateEntry *date,
+                            gsize len)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->buffer_len < len)
+		{
+			priv->buffer = g_realloc (priv->buffer, len);
+			priv->buffer_len = len;
+		}
+	priv->buffer[0] = '\0';
+
+	return priv->buffer;
+}
+
+/* writes the value with @fmt, only the date if the time isn't visible */
+static gsize
+gtk_date_entry_write (GtkDateEntry *date,
+                      const GtkDateFormat *fmt,
+                      gchar *buf,
+                      gsize len)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (!priv->value.valid)
+		{
+			if (len > 0)
+				{
+					buf[0] = '\0';
+				}
+			return 0;
+		}
+
+	if (priv->time_is_visible)
+		{
+			return gtk_date_format_format (fmt, priv->value.julian, priv->value.seconds, buf, len);
+		}
+	else
+		{
+			return gtk_date_format_format_date (fmt, priv->value.julian, buf, len);
+		}
 }
 
 static void
@@ -221,20 +557,33 @@ gtk_date_entry_init (GtkDateEntry *date)
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	priv->separator = gtk_date_entry_get_separator_from_locale ();
-	priv->time_separator = ":";
-	priv->format = gtk_date_entry_get_format_from_locale ();
+	/* the format and the separator are set by the construct properties,
+	 * and the format is compiled once in constructed */
+	priv->format = NULL;
+	priv->separator = NULL;
+	priv->time_separator = g_intern_static_string (":");
 
 	priv->hbox = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
 	gtk_container_add (GTK_CONTAINER (date), priv->hbox);
 	gtk_widget_show (priv->hbox);
 
 	priv->day = gtk_masked_entry_new ();
-	gtk_date_entry_change_mask (date);
-	gtk_entry_set_width_chars (GTK_ENTRY (priv->day), 10);
 	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->day, TRUE, TRUE, 0);
 	gtk_widget_show (priv->day);
 
+	g_signal_connect (G_OBJECT (priv->day), "insert-text",
+	                  G_CALLBACK (day_on_insert_text), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->day), "delete-text",
+	                  G_CALLBACK (day_on_delete_text), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->day), "changed",
+	                  G_CALLBACK (day_on_changed), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->day), "activate",
+	                  G_CALLBACK (part_on_activate), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->day), "key-press-event",
+	                  G_CALLBACK (part_on_key_press_event), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->day), "focus-out-event",
+	                  G_CALLBACK (part_on_focus_out_event), (gpointer)date);
+
 	priv->btnCalendar = gtk_toggle_button_new ();
 	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->btnCalendar, FALSE, FALSE, 0);
 	gtk_widget_set_no_show_all (priv->btnCalendar, TRUE);
@@ -247,68 +596,90 @@ gtk_date_entry_init (GtkDateEntry *date)
 	gtk_container_add (GTK_CONTAINER (priv->btnCalendar), arrow);
 	gtk_widget_show (arrow);
 
-	priv->wCalendar = gtk_window_new (GTK_WINDOW_POPUP);
-	gtk_window_set_resizable (GTK_WINDOW (priv->wCalendar), FALSE);
-	gtk_container_set_border_width (GTK_CONTAINER (priv->wCalendar), 3);
+	priv->date_is_visible = TRUE;
+	priv->time_is_visible = TRUE;
+	priv->time_with_seconds = TRUE;
+	priv->date_cleared = TRUE;
 
-	gtk_widget_set_events (priv->wCalendar,
-	                       gtk_widget_get_events (priv->wCalendar) | GDK_KEY_PRESS_MASK);
+	/* the time's widgets are built when the time part is shown */
+}
 
-	g_signal_connect (priv->wCalendar, "delete_event",
-	                  G_CALLBACK (delete_popup), date);
-	g_signal_connect (priv->wCalendar, "key_press_event",
-	                  G_CALLBACK (key_press_popup), date);
-	g_signal_connect (priv->wCalendar, "button_press_event",
-	                  G_CALLBACK (button_press_popup), date);
+static void
+gtk_date_entry_constructed (GObject *object)
+{
+	GtkDateFormat *fmt;
 
-	priv->calendar = gtk_calendar_new ();
-	gtk_container_add (GTK_CONTAINER (priv->wCalendar), priv->calendar);
-	gtk_widget_show (priv->calendar);
+	GtkDateEntry *date = GTK_DATE_ENTRY (object);
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	g_signal_connect (G_OBJECT (priv->calendar), "day-selected",
-	                  G_CALLBACK (calendar_on_day_selected), (gpointer)date);
-	g_signal_connect (G_OBJECT (priv->calendar), "day-selected-double-click",
-	                  G_CALLBACK (calendar_on_day_selected_double_click), (gpointer)date);
+	if (G_OBJECT_CLASS (parent_class)->constructed != NULL)
+		{
+			G_OBJECT_CLASS (parent_class)->constructed (object);
+		}
 
-	priv->date_is_visible = TRUE;
-	priv->time_is_visible = TRUE;
-	priv->time_with_seconds = TRUE;
+	if (priv->format == NULL || priv->separator == NULL)
+		{
+			fmt = _gtk_date_entry_ref_locale_format ();
+			if (priv->format == NULL)
+				{
+					priv->format = gtk_date_format_get_format (fmt);
+				}
+			if (priv->separator == NULL)
+				{
+					priv->separator = gtk_date_format_get_separator (fmt);
+				}
+			gtk_date_format_unref (fmt);
+		}
 
-	priv->spnHours = gtk_spin_button_new_with_range (0, 23, 1);
-	gtk_entry_set_width_chars (GTK_ENTRY (priv->spnHours), 2);
-	gtk_widget_set_no_show_all (priv->spnHours, TRUE);
+	gtk_date_entry_compile_format (date);
+	gtk_date_entry_change_mask (date);
 
-	priv->lblMinutes = gtk_label_new (":");
-	gtk_widget_set_no_show_all (priv->lblMinutes, TRUE);
-	priv->spnMinutes = gtk_spin_button_new_with_range (0, 59, 1);
-	gtk_entry_set_width_chars (GTK_ENTRY (priv->spnMinutes), 2);
-	gtk_widget_set_no_show_all (priv->spnMinutes, TRUE);
+	priv->constructed = TRUE;
+}
 
-	priv->lblSeconds = gtk_label_new (":");
-	gtk_widget_set_no_show_all (priv->lblSeconds, TRUE);
-	priv->spnSeconds = gtk_spin_button_new_with_range (0, 59, 1);
-	gtk_entry_set_width_chars (GTK_ENTRY (priv->spnSeconds), 2);
-	gtk_widget_set_no_show_all (priv->spnSeconds, TRUE);
+static void
+gtk_date_entry_dispose (GObject *object)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (object);
 
-	gtk_spin_button_set_numeric (GTK_SPIN_BUTTON (priv->spnHours), TRUE);
-	gtk_spin_button_set_numeric (GTK_SPIN_BUTTON (priv->spnMinutes), TRUE);
-	gtk_spin_button_set_numeric (GTK_SPIN_BUTTON (priv->spnSeconds), TRUE);
+	if (popup.owner == (GtkDateEntry *)object)
+		{
+			hide_popup (GTK_WIDGET (object));
+		}
 
-	gtk_spin_button_set_digits (GTK_SPIN_BUTTON (priv->spnHours), 0);
-	gtk_spin_button_set_digits (GTK_SPIN_BUTTON (priv->spnMinutes), 0);
-	gtk_spin_button_set_digits (GTK_SPIN_BUTTON (priv->spnSeconds), 0);
+	if (priv->rules != NULL)
+		{
+			g_signal_handler_disconnect (priv->rules, priv->rules_changed_id);
+			g_object_unref (priv->rules);
+			priv->rules = NULL;
+		}
 
-	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->spnHours, TRUE, TRUE, 0);
-	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->lblMinutes, FALSE, FALSE, 3);
-	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->spnMinutes, TRUE, TRUE, 0);
-	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->lblSeconds, FALSE, FALSE, 3);
-	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->spnSeconds, TRUE, TRUE, 0);
+	if (priv->focus_check_id != 0)
+		{
+			g_source_remove (priv->focus_check_id);
+			priv->focus_check_id = 0;
+		}
+
+	G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
+static void
+gtk_date_entry_finalize (GObject *object)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (object);
+
+	gtk_date_format_unref (priv->compiled);
+	if (priv->strf_format != NULL)
+		{
+			gtk_date_format_unref (priv->strf_format);
+		}
+	g_free (priv->buffer);
+	if (priv->tz != NULL)
+		{
+			g_time_zone_unref (priv->tz);
+		}
 
-	gtk_widget_show (priv->spnHours);
-	gtk_widget_show (priv->lblMinutes);
-	gtk_widget_show (priv->spnMinutes);
-	gtk_widget_show (priv->lblSeconds);
-	gtk_widget_show (priv->spnSeconds);
+	G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
 static void
@@ -319,6 +690,32 @@ gtk_date_entry_gdaex_query_editor_iwidget_interface_init (GdaExQueryEditorIWidge
 	iface->set_value = gtk_date_entry_set_value;
 }
 
+static void
+gtk_date_entry_cell_editable_interface_init (GtkCellEditableIface *iface)
+{
+	iface->start_editing = gtk_date_entry_start_editing;
+}
+
+/*
+ * the same entry can edit the cells of a whole list: it ends the editing
+ * with Enter in the date, with Escape (canceled), with a double click in
+ * the calendar, or when the focus leaves it; the calendar's popup
+ * doesn't end it
+ */
+static void
+gtk_date_entry_start_editing (GtkCellEditable *cell_editable,
+                              GdkEvent *event)
+{
+	GtkDateEntry *date = GTK_DATE_ENTRY (cell_editable);
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	priv->editing = TRUE;
+	priv->editing_canceled = FALSE;
+
+	gtk_widget_grab_focus (priv->day);
+	gtk_editable_select_region (GTK_EDITABLE (priv->day), 0, -1);
+}
+
 /**
  * gtk_date_entry_new:
  * @format: a #gchar which is the date's format.
@@ -336,40 +733,79 @@ gtk_date_entry_gdaex_query_editor_iwidget_interface_init (GdaExQueryEditorIWidge
 GtkWidget
 *gtk_date_entry_new (const gchar *format, const gchar *separator, gboolean calendar_button_is_visible)
 {
-	gchar *_format;
-	gchar *_separator;
-
-	GtkWidget *w = GTK_WIDGET (g_object_new (gtk_date_entry_get_type (), NULL));
-
-	if (format == NULL)
-		{
-			_format = gtk_date_entry_get_format_from_locale ();
-		}
-	else
-		{
-			_format = g_strdup (format);
-		}
-	if (!gtk_date_entry_set_format (GTK_DATE_ENTRY (w), _format))
+	if ((format != NULL && _gtk_date_entry_intern_format (format) == NULL)
+	    || (separator != NULL && _gtk_date_entry_intern_separator (separator) == NULL))
 		{
 			return NULL;
 		}
 
-	if (separator == NULL)
-		{
-			_separator = gtk_date_entry_get_separator_from_locale ();
-		}
-	else
+	return GTK_WIDGET (g_object_new (gtk_date_entry_get_type (),
+	                                 "format", format,
+	                                 "separator", separator,
+	                                 "calendar-button-visible", calendar_button_is_visible,
+	                                 NULL));
+}
+
+/**
+ * gtk_date_entry_locale_changed:
+ *
+ * Reads again the date's format and separator from the locale; they are
+ * read once and shared by all the #GtkDateEntry, so this must be called
+ * after changing the locale (e.g. with setlocale()). The entries already
+ * built keep their format.
+ */
+void
+gtk_date_entry_locale_changed (void)
+{
+	G_LOCK (locale_format);
+
+	if (locale_format != NULL)
 		{
-			_separator = g_strdup (separator);
+			gtk_date_format_unref (locale_format);
+			locale_format = NULL;
 		}
-	if (!gtk_date_entry_set_separator (GTK_DATE_ENTRY (w), _separator))
+
+	G_UNLOCK (locale_format);
+}
+
+/**
+ * gtk_date_entry_time_zone_changed:
+ *
+ * Resolves again the local time zone; it is resolved once and shared by
+ * all the #GtkDateEntry, so this must be called after changing it (e.g.
+ * after setting TZ, or when the system's one changes). Like the other
+ * GTK+ calls, it must be called from the main thread.
+ */
+void
+gtk_date_entry_time_zone_changed (void)
+{
+	if (local_tz != NULL)
 		{
-			return NULL;
+			g_time_zone_unref (local_tz);
+			local_tz = NULL;
 		}
+}
 
-	gtk_date_entry_set_calendar_button_visible (GTK_DATE_ENTRY (w), calendar_button_is_visible);
-
-	return w;
+/**
+ * gtk_date_entry_get_update_counters:
+ * @applied: (out) (allow-none): the setters' calls that changed something.
+ * @skipped: (out) (allow-none): the setters' calls that returned early,
+ * because the new state was the current one.
+ *
+ * Gets the counters of all the entries; they are always 0 unless the
+ * library is built with --enable-debug.
+ */
+void
+gtk_date_entry_get_update_counters (guint *applied,
+                                    guint *skipped)
+{
+#ifdef GTK_DATE_ENTRY_DEBUG
+	if (applied != NULL) *applied = updates_applied;
+	if (skipped != NULL) *skipped = updates_skipped;
+#else
+	if (applied != NULL) *applied = 0;
+	if (skipped != NULL) *skipped = 0;
+#endif
 }
 
 /**
@@ -382,29 +818,38 @@ GtkWidget
 gboolean
 gtk_date_entry_set_separator (GtkDateEntry *date, const gchar *separator)
 {
-	gchar *_separator;
+	const gchar *_separator;
+	gint32 julian;
 
 	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), FALSE);
 
-	GDate *gdate = gtk_date_entry_get_gdate (date);
-
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	if (separator == NULL)
+	_separator = _gtk_date_entry_intern_separator (separator);
+	if (_separator == NULL)
 		{
 			return FALSE;
 		}
-	_separator = g_strstrip (g_strdup (separator));
-	if (strlen (_separator) != 1)
+
+	if (_separator == priv->separator && priv->constructed)
 		{
-			return FALSE;
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return TRUE;
 		}
 
-	priv->separator = g_strdup (_separator);
-	gtk_date_entry_change_mask (date);
-	gtk_date_entry_set_date_gdate (date, gdate);
+	priv->separator = _separator;
+	if (!priv->constructed)
+		{
+			return TRUE;
+		}
 
-	g_free (_separator);
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	julian = priv->value.valid ? priv->value.julian : 0;
+
+	gtk_date_entry_compile_format (date);
+	gtk_date_entry_change_mask (date);
+	gtk_date_entry_set_date_julian (date, julian);
 
 	return TRUE;
 }
@@ -419,27 +864,40 @@ gtk_date_entry_set_separator (GtkDateEntry *date, const gchar *separator)
 gboolean
 gtk_date_entry_set_time_separator (GtkDateEntry *date, const gchar *separator)
 {
-	gchar *_separator;
+	const gchar *_separator;
 
 	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), FALSE);
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	if (separator == NULL)
+	_separator = _gtk_date_entry_intern_separator (separator);
+	if (_separator == NULL)
 		{
 			return FALSE;
 		}
-	_separator = g_strstrip (g_strdup (separator));
-	if (strlen (_separator) != 1)
+
+	if (_separator == priv->time_separator && priv->constructed)
 		{
-			return FALSE;
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return TRUE;
+		}
+
+	priv->time_separator = _separator;
+	if (!priv->constructed)
+		{
+			return TRUE;
 		}
 
-	priv->time_separator = g_strdup (_separator);
-	gtk_label_set_text (GTK_LABEL (priv->lblMinutes), _separator);
-	gtk_label_set_text (GTK_LABEL (priv->lblSeconds), _separator);
+	GTK_DATE_ENTRY_COUNT (updates_applied);
 
-	g_free (_separator);
+	gtk_date_entry_compile_format (date);
+	if (priv->spnHours != NULL)
+		{
+			gtk_label_set_text (GTK_LABEL (priv->lblMinutes), _separator);
+			gtk_label_set_text (GTK_LABEL (priv->lblSeconds), _separator);
+		}
+
+	return TRUE;
 }
 
 /**
@@ -454,241 +912,302 @@ gtk_date_entry_set_time_separator (GtkDateEntry *date, const gchar *separator)
 gboolean
 gtk_date_entry_set_format (GtkDateEntry *date, const gchar *format)
 {
-	gint i;
-	gboolean d = FALSE;
-	gboolean m = FALSE;
-	gboolean y = FALSE;
-	gchar *format_;
-	GDate *gdate;
+	const gchar *_format;
+	gint32 julian;
 
 	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), FALSE);
 	g_return_val_if_fail (format != NULL, FALSE);
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	format_ = g_strstrip (g_strdup (format));
-	if (strlen (format_) != 3)
+	_format = _gtk_date_entry_intern_format (format);
+	if (_format == NULL)
 		{
 			return FALSE;
 		}
 
-	for (i = 0; i < 3; i++)
+	if (_format == priv->format && priv->constructed)
 		{
-			switch (format_[i])
-				{
-					case 'd':
-						if (d) return FALSE;
-						d = TRUE;
-						break;
-
-					case 'm':
-						if (m) return FALSE;
-						m = TRUE;
-						break;
-
-					case 'Y':
-						if (y) return FALSE;
-						y = TRUE;
-						break;
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return TRUE;
+		}
 
-					default:
-						return FALSE;
-				}
+	priv->format = _format;
+	if (!priv->constructed)
+		{
+			return TRUE;
 		}
-	if (!d || !m || !y) return FALSE; 
 
-	gdate = gtk_date_entry_get_gdate (date);
+	GTK_DATE_ENTRY_COUNT (updates_applied);
 
-	priv->format = g_strdup (format_);
-	gtk_date_entry_change_mask (date);
-	gtk_date_entry_set_date_gdate (date, gdate);
+	julian = priv->value.valid ? priv->value.julian : 0;
 
-	g_free (format_);
+	gtk_date_entry_compile_format (date);
+	gtk_date_entry_change_mask (date);
+	gtk_date_entry_set_date_julian (date, julian);
 
 	return TRUE;
 }
 
 /**
- * gtk_date_entry_get_text:
+ * gtk_date_entry_get_text_into:
  * @date: a #GtkDateEntry object.
+ * @buf: the buffer to write into.
+ * @len: the size of @buf.
  *
- * Returns the @date's content as is.
+ * Writes the @date's content as is into @buf, without allocating memory.
  *
- * Returns: A pointer to the content of the widget as is.
+ * Returns: the length of the content, without the terminating nul. If it
+ * isn't less than @len, @buf isn't big enough and it is left empty.
  */
-const gchar
-*gtk_date_entry_get_text (GtkDateEntry *date)
+gsize
+gtk_date_entry_get_text_into (GtkDateEntry *date,
+                              gchar *buf,
+                              gsize len)
 {
-	gchar *ret;
+	const gchar *text;
+	gsize text_len;
+	gsize ret;
 
 	GtkDateEntryPrivate *priv;
 
-	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), NULL);
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), 0);
+	g_return_val_if_fail (buf != NULL || len == 0, 0);
 
 	priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
-	ret = (gchar *)gtk_entry_get_text (GTK_ENTRY (priv->day));
 
-	if (gtk_widget_get_visible (priv->spnHours))
+	text = gtk_entry_get_text (GTK_ENTRY (priv->day));
+	text_len = strlen (text);
+
+	ret = text_len;
+	if (priv->time_is_visible)
+		{
+			/* " HH:MM:SS" */
+			ret += 7 + 2 * strlen (priv->time_separator);
+		}
+
+	if (len < ret + 1)
+		{
+			if (len > 0)
+				{
+					buf[0] = '\0';
+				}
+			return ret;
+		}
+
+	memcpy (buf, text, text_len);
+	buf[text_len] = '\0';
+	if (priv->time_is_visible)
 		{
-			ret = g_strconcat (ret,
-			                   g_strdup_printf (" %02d%s%02d%s%02d",
-			                                    gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnHours)),
-			                                    priv->time_separator,
-			                                    gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnMinutes)),
-			                                    priv->time_separator,
-			                                    gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnSeconds))),
-			                   NULL);
+			g_snprintf (buf + text_len, len - text_len, " %02d%s%02d%s%02d",
+			            priv->value.seconds / 3600,
+			            priv->time_separator,
+			            (priv->value.seconds / 60) % 60,
+			            priv->time_separator,
+			            priv->value.seconds % 60);
 		}
 
 	return ret;
 }
 
 /**
- * gtk_date_entry_get_strf:
+ * gtk_date_entry_dup_text:
  * @date: a #GtkDateEntry object.
- * @format: a #gchar which is the date's format.
- * @separator: a #gchar which is the separator between day, month and year.
  *
- * Returns: A pointer to the content of the widget formatted as specified in 
- * @format with @separator.
+ * Returns: (transfer full): a newly allocated copy of the @date's content as
+ * is; free it with g_free().
  */
-const gchar
-*gtk_date_entry_get_strf (GtkDateEntry *date,
-                          const gchar *format,
-                          const gchar *separator,
-                          const gchar *time_separator)
+gchar
+*gtk_date_entry_dup_text (GtkDateEntry *date)
 {
-	GDateTime *gdate;
+	gchar *ret;
+	gsize len;
 
-	GtkDateEntryPrivate *priv;
-
-	gchar *fmt;
-	gchar *sep;
-	gchar *tsep;
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), NULL);
 
-	gchar *str_date;
-	gchar *str_time;
+	len = gtk_date_entry_get_text_into (date, NULL, 0) + 1;
+	ret = g_malloc (len);
+	gtk_date_entry_get_text_into (date, ret, len);
 
-	guint l;
-	guint i;
+	return ret;
+}
 
-	gchar *ret;
+/**
+ * gtk_date_entry_get_text:
+ * @date: a #GtkDateEntry object.
+ *
+ * Returns the @date's content as is.
+ *
+ * Returns: (transfer none): A pointer to the content of the widget as is; it
+ * is owned by @date and it is valid until the next call of
+ * gtk_date_entry_get_text(), gtk_date_entry_get_strf() or
+ * gtk_date_entry_get_sql().
+ */
+const gchar
+*gtk_date_entry_get_text (GtkDateEntry *date)
+{
+	gsize len;
 
-	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), "");
+	GtkDateEntryPrivate *priv;
 
-	gdate = gtk_date_entry_get_gdatetime (date);
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), NULL);
 
 	priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	if (gdate == NULL)
+	if (!priv->time_is_visible)
 		{
-			return "";
+			return gtk_entry_get_text (GTK_ENTRY (priv->day));
 		}
 
-	str_date = g_strdup ("");
-	str_time = g_strdup ("");
+	len = gtk_date_entry_get_text_into (date, NULL, 0) + 1;
+	gtk_date_entry_get_text_into (date, gtk_date_entry_get_buffer (date, len), len);
 
-	if (format == NULL)
-		{
-			fmt = g_strdup (priv->format);
-		}
-	else
-		{
-			fmt = g_strdup (format);
-		}
+	return priv->buffer;
+}
 
-	if (separator == NULL)
-		{
-			sep = g_strdup (priv->separator);
-		}
-	else
-		{
-			sep = g_strdup (separator);
-		}
+/**
+ * gtk_date_entry_format_into:
+ * @date: a #GtkDateEntry object.
+ * @format: (allow-none): the date's format; NULL for the @date's one.
+ * @separator: (allow-none): the separator between day, month and year; NULL
+ * for the @date's one.
+ * @time_separator: (allow-none): the separator between hours, minutes and
+ * seconds; NULL for the @date's one.
+ * @buf: the buffer to write into.
+ * @len: the size of @buf.
+ *
+ * Writes the @date's content formatted as specified in @format into @buf,
+ * without allocating memory once the format is compiled.
+ *
+ * Returns: the length of the formatted string, without the terminating nul;
+ * 0 if @date isn't valid. If it isn't less than @len, @buf isn't big enough
+ * and it is left empty.
+ */
+gsize
+gtk_date_entry_format_into (GtkDateEntry *date,
+                            const gchar *format,
+                            const gchar *separator,
+                            const gchar *time_separator,
+                            gchar *buf,
+                            gsize len)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), 0);
+	g_return_val_if_fail (buf != NULL || len == 0, 0);
 
-	if (time_separator == NULL)
-		{
-			tsep = g_strdup (priv->time_separator);
-		}
-	else
-		{
-			tsep = g_strdup (time_separator);
-		}
+	return gtk_date_entry_write (date,
+	                             gtk_date_entry_get_strf_format (date, format, separator, time_separator),
+	                             buf, len);
+}
 
-	l = strlen (fmt);
-	for (i = 0; i < l; i++)
-		{
-			switch (fmt[i])
-				{
-					case 'd':
-						if (strlen (str_date) > 0)
-							{
-								str_date = g_strconcat (str_date, sep, NULL);
-							}
-						str_date = g_strconcat (str_date, g_strdup_printf ("%02d", g_date_time_get_day_of_month (gdate)), NULL);
-						break;
+/**
+ * gtk_date_entry_dup_strf:
+ * @date: a #GtkDateEntry object.
+ * @format: (allow-none): the date's format.
+ * @separator: (allow-none): the separator between day, month and year.
+ * @time_separator: (allow-none): the separator between hours, minutes and
+ * seconds.
+ *
+ * Returns: (transfer full): a newly allocated string with the content of the
+ * widget formatted as specified in @format; free it with g_free().
+ */
+gchar
+*gtk_date_entry_dup_strf (GtkDateEntry *date,
+                          const gchar *format,
+                          const gchar *separator,
+                          const gchar *time_separator)
+{
+	GtkDateFormat *fmt;
+	gchar *ret;
+	gsize len;
 
-					case 'm':
-						if (strlen (str_date) > 0)
-							{
-								str_date = g_strconcat (str_date, sep, NULL);
-							}
-						str_date = g_strconcat (str_date, g_strdup_printf ("%02d", g_date_time_get_month (gdate)), NULL);
-						break;
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), NULL);
 
-					case 'Y':
-						if (strlen (str_date) > 0)
-							{
-								str_date = g_strconcat (str_date, sep, NULL);
-							}
-						str_date = g_strconcat (str_date, g_strdup_printf ("%04d", g_date_time_get_year (gdate)), NULL);
-						break;
+	fmt = gtk_date_entry_get_strf_format (date, format, separator, time_separator);
 
-					case 'H':
-						if (priv->time_is_visible)
-							{
-								if (strlen (str_time) > 0)
-									{
-										str_time = g_strconcat (str_time, tsep, NULL);
-									}
-								str_time = g_strconcat (str_time, g_strdup_printf ("%02d", g_date_time_get_hour (gdate)), NULL);
-							}
-						break;
+	len = gtk_date_format_get_width (fmt) + 1;
+	ret = g_malloc (len);
+	gtk_date_entry_write (date, fmt, ret, len);
 
-					case 'M':
-						if (priv->time_is_visible)
-							{
-								if (strlen (str_time) > 0)
-									{
-										str_time = g_strconcat (str_time, tsep, NULL);
-									}
-								str_time = g_strconcat (str_time, g_strdup_printf ("%02d", g_date_time_get_minute (gdate)), NULL);
-							}
-						break;
+	return ret;
+}
 
-					case 'S':
-						if (priv->time_is_visible)
-							{
-								if (strlen (str_time) > 0)
-									{
-										str_time = g_strconcat (str_time, tsep, NULL);
-									}
-								str_time = g_strconcat (str_time, g_strdup_printf ("%02.0f", g_date_time_get_seconds (gdate)), NULL);
-							}
-						break;
-				}
-		}
+/**
+ * gtk_date_entry_get_strf:
+ * @date: a #GtkDateEntry object.
+ * @format: a #gchar which is the date's format.
+ * @separator: the string between day, month and year, of any length.
+ * @time_separator: the string between hours, minutes and seconds, of any
+ * length.
+ *
+ * Returns: (transfer none): A pointer to the content of the widget formatted
+ * as specified in @format with @separator; it is owned by @date and it is
+ * valid until the next call of gtk_date_entry_get_text(),
+ * gtk_date_entry_get_strf() or gtk_date_entry_get_sql().
+ */
+const gchar
+*gtk_date_entry_get_strf (GtkDateEntry *date,
+                          const gchar *format,
+                          const gchar *separator,
+                          const gchar *time_separator)
+{
+	GtkDateFormat *fmt;
+	gsize len;
 
-	ret = g_strstrip (g_strdup (str_date));
-	if (priv->time_is_visible)
-		{
-			ret = g_strconcat (ret, " ", g_strstrip (str_time), NULL);
-		}
+	GtkDateEntryPrivate *priv;
+
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), "");
+
+	priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	fmt = gtk_date_entry_get_strf_format (date, format, separator, time_separator);
+
+	len = gtk_date_format_get_width (fmt) + 1;
+	gtk_date_entry_write (date, fmt, gtk_date_entry_get_buffer (date, len), len);
+
+	return priv->buffer;
+}
+
+/**
+ * gtk_date_entry_get_sql_into:
+ * @date: a #GtkDateEntry object.
+ * @buf: the buffer to write into.
+ * @len: the size of @buf.
+ *
+ * Writes the @date's content formatted for sql into @buf, without
+ * allocating memory.
+ *
+ * Returns: the length of the formatted string, as
+ * gtk_date_entry_format_into().
+ */
+gsize
+gtk_date_entry_get_sql_into (GtkDateEntry *date,
+                             gchar *buf,
+                             gsize len)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), 0);
+	g_return_val_if_fail (buf != NULL || len == 0, 0);
+
+	return gtk_date_entry_write (date, _gtk_date_entry_get_sql_format (), buf, len);
+}
+
+/**
+ * gtk_date_entry_dup_sql:
+ * @date: a #GtkDateEntry object.
+ *
+ * Returns: (transfer full): a newly allocated string with the content of the
+ * widget formatted for sql; free it with g_free().
+ */
+gchar
+*gtk_date_entry_dup_sql (GtkDateEntry *date)
+{
+	gchar *ret;
+	gsize len;
+
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), NULL);
 
-	g_free (fmt);
-	g_free (sep);
-	g_free (tsep);
-	g_date_time_unref (gdate);
+	len = gtk_date_format_get_width (_gtk_date_entry_get_sql_format ()) + 1;
+	ret = g_malloc (len);
+	gtk_date_entry_get_sql_into (date, ret, len);
 
 	return ret;
 }
@@ -697,16 +1216,26 @@ const gchar
  * gtk_date_entry_get_sql:
  * @date: a #GtkDateEntry object.
  *
- * Returns: A pointer to the content of the widget formatted for sql.
+ * Returns: (transfer none): A pointer to the content of the widget formatted
+ * for sql; it is owned by @date and it is valid until the next call of
+ * gtk_date_entry_get_text(), gtk_date_entry_get_strf() or
+ * gtk_date_entry_get_sql().
  */
 const gchar
 *gtk_date_entry_get_sql (GtkDateEntry *date)
 {
+	gsize len;
+
+	GtkDateEntryPrivate *priv;
+
 	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), "");
 
-	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+	priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	return gtk_date_entry_get_strf (date, "YmdHMS", "-", ":");
+	len = gtk_date_format_get_width (_gtk_date_entry_get_sql_format ()) + 1;
+	gtk_date_entry_get_sql_into (date, gtk_date_entry_get_buffer (date, len), len);
+
+	return priv->buffer;
 }
 
 /**
@@ -718,31 +1247,16 @@ const gchar
 struct tm
 *gtk_date_entry_get_tm (GtkDateEntry *date)
 {
-	struct tm *tm;
-
-	const GDate *gdate;
 	GtkDateEntryPrivate *priv;
 
 	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), NULL);
 
 	priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	tm = g_malloc0 (sizeof (struct tm));
-
-	gdate = gtk_date_entry_get_gdate (date);
-
-	if (gdate == NULL) return NULL;
+	if (!priv->value.valid) return NULL;
 
-	g_date_to_struct_tm (gdate, tm);
-
-	if (priv->time_is_visible)
-		{
-			tm->tm_hour = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnHours));
-			tm->tm_min = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnMinutes));
-			tm->tm_sec = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnSeconds));
-		}
-
-	return tm;
+	return _gtk_date_entry_value_to_tm (priv->value.julian,
+	                                    priv->time_is_visible ? priv->value.seconds : 0);
 }
 
 /**
@@ -754,80 +1268,16 @@ struct tm
 GDate
 *gtk_date_entry_get_gdate (GtkDateEntry *date)
 {
-	gint i;
-	gint pos = 0;
-	gint val;
-	gchar *txt;
-	GDate *gdate;
-	GDateDay gday;
-	GDateMonth gmon;
-	GDateYear gyear;
-
 	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), NULL);
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	gday = G_DATE_BAD_DAY;
-	gmon = G_DATE_BAD_MONTH;
-	gyear = G_DATE_BAD_YEAR;
-
-	txt = (gchar *)gtk_entry_get_text (GTK_ENTRY (priv->day));
-
-	for (i = 0; i < 3; i++)
-		{
-			switch (priv->format[i])
-				{
-					case 'd':
-						val = strtol (g_strndup (txt + pos, 2), NULL, 10);
-						if (g_date_valid_day ((GDateDay)val))
-							{
-								gday = (GDateDay)val;
-								pos += 3;
-							}
-						else
-							{
-								return NULL;
-							}
-						break;
-
-					case 'm':
-						val = strtol (g_strndup (txt + pos, 2), NULL, 10);
-						if (g_date_valid_month ((GDateMonth)val))
-							{
-								gmon = (GDateMonth)val;
-								pos += 3;
-							}
-						else
-							{
-								return NULL;
-							}
-						break;
-
-					case 'Y':
-						val = strtol (g_strndup (txt + pos, 4), NULL, 10);
-						if (g_date_valid_year ((GDateYear)val))
-							{
-								gyear = (GDateYear)val;
-								pos += 5;
-							}
-						else
-							{
-								return NULL;
-							}
-						break;
-				}
-		}
-
-	if (g_date_valid_day (gday)
-		&& g_date_valid_month (gmon)
-		&& g_date_valid_year (gyear))
-		{
-			return g_date_new_dmy (gday, gmon, gyear);
-		}
-	else
+	if (!priv->value.valid)
 		{
 			return NULL;
 		}
+
+	return g_date_new_julian (priv->value.julian);
 }
 
 /**
@@ -839,44 +1289,18 @@ GDate
 GDateTime
 *gtk_date_entry_get_gdatetime (GtkDateEntry *date)
 {
-	GDateTime *ret;
-	GDate *gdate;
-
-	gint hour;
-	gint minute;
-	gdouble seconds;
-
 	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), NULL);
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	gdate = gtk_date_entry_get_gdate (date);
-	if (gdate == NULL)
+	if (!priv->value.valid)
 		{
 			return NULL;
 		}
 
-	hour = 0;
-	minute = 0;
-	seconds = 0.0;
-	if (priv->time_is_visible)
-		{
-			hour = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnHours));
-			minute = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnMinutes));
-			if (priv->time_with_seconds)
-				{
-					seconds = gtk_spin_button_get_value (GTK_SPIN_BUTTON (priv->spnSeconds));
-				}
-		}
-
-	ret = g_date_time_new_local (g_date_get_year (gdate),
-	                             g_date_get_month (gdate),
-	                             g_date_get_day (gdate),
-	                             hour,
-	                             minute,
-	                             seconds);
-
-	return ret;
+	return _gtk_date_entry_value_to_gdatetime (gtk_date_entry_get_conversion_zone (date),
+	                                           priv->value.julian,
+	                                           gtk_date_entry_get_seconds (date));
 }
 
 /**
@@ -884,7 +1308,8 @@ GDateTime
  * @date: a #GtkDateEntry.
  * @str: a #gchar which is the content to set.
  * @format: a #gchar which is the date's format.
- * @separator: a #gchar which is the separator between day, month and year.
+ * @separator: the string between day, month and year, of any length, the
+ * same given to gtk_date_entry_get_strf().
  *
  * Sets @date's content from the @str string and based on @format and @separator, 
  * if it's a valid date.
@@ -896,20 +1321,9 @@ gtk_date_entry_set_date_strf (GtkDateEntry *date,
                               const gchar *str,
                               const gchar *format)
 {
-	gchar *fmt;
-
-	gint year;
-	gint month;
-	gint day;
-	gint hours;
-	gint minutes;
-	gdouble seconds;
-
-	gint i;
-	gint l;
-	gint pos;
-
-	GDateTime *gdatetime;
+	GtkDateFormat *fmt;
+	gint32 julian;
+	gint32 seconds;
 
 	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), FALSE);
 
@@ -917,85 +1331,54 @@ gtk_date_entry_set_date_strf (GtkDateEntry *date,
 
 	if (format == NULL)
 		{
-			fmt = priv->format;
+			fmt = priv->compiled;
 		}
 	else
 		{
-			fmt = g_strdup (format);
+			fmt = gtk_date_entry_get_strf_format (date, format, NULL, NULL);
 		}
 
-	year = 0;
-	month = 0;
-	day = 0;
-	hours = 0;
-	minutes = 0;
-	seconds = 0.0;
-
-	pos = 0;
-	l = strlen (fmt);
-	for (i = 0; i < l; i++)
-		{
-			switch (fmt[i])
-				{
-					case 'd':
-						day = strtol (g_strndup (str + pos, 2), NULL, 10);
-						pos += 3;
-						break;
-
-					case 'm':
-						month = strtol (g_strndup (str + pos, 2), NULL, 10);
-						pos += 3;
-						break;
-
-					case 'Y':
-						year = strtol (g_strndup (str + pos, 4), NULL, 10);
-						pos += 5;
-						break;
-
-					case 'H':
-						hours = strtol (g_strndup (str + pos, 2), NULL, 10);
-						pos += 3;
-						break;
+	/* TODO
+	 * when only time part is visible, it must set only the time part
+	 */
+	gtk_date_format_parse (fmt, str, &julian, &seconds);
+	gtk_date_entry_set_value_julian (date, julian, seconds);
 
-					case 'M':
-						minutes = strtol (g_strndup (str + pos, 2), NULL, 10);
-						pos += 3;
-						break;
+	return TRUE;
+}
 
-					case 'S':
-						seconds = g_strtod (g_strndup (str + pos, 2), NULL);
-						pos += 3;
-						break;
-				}
+/**
+ * gtk_date_entry_set_sql:
+ * @date: a #GtkDateEntry.
+ * @str: (allow-none): a date or a timestamp formatted for sql, as returned
+ * by gtk_date_entry_get_sql(); NULL or empty to clear @date.
+ *
+ * Sets @date's content from @str with the format shared by
+ * gtk_date_entry_get_sql(), compiled once, so reading a record doesn't
+ * build a format for every field.
+ *
+ * Returns: FALSE if @str isn't a valid date; then @date is cleared.
+ */
+gboolean
+gtk_date_entry_set_sql (GtkDateEntry *date,
+                        const gchar *str)
+{
+	gint32 julian;
+	gint32 seconds;
+	gboolean ret;
 
-			if (pos >= strlen (str))
-				{
-					i = l;
-					continue;
-				}
-		}
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), FALSE);
 
-	if (year == 0
-	    || month == 0
-	    || day == 0)
-		{
-			/* TODO
-			 * when only time part is visible, it must set only the time part
-			 */
-			gdatetime = NULL;
-		}
-	else
+	if (str == NULL || str[0] == '\0')
 		{
-			gdatetime = g_date_time_new_local (year, month, day, hours, minutes, seconds);
+			gtk_date_entry_set_value_julian (date, 0, 0);
+			return TRUE;
 		}
-	gtk_date_entry_set_date_gdatetime (date, gdatetime);
 
-	if (gdatetime != NULL)
-		{
-			g_date_time_unref (gdatetime);
-		}
+	ret = gtk_date_format_parse (_gtk_date_entry_get_sql_format (), str, &julian, &seconds);
+	gtk_date_entry_set_value_julian (date, ret ? julian : 0, ret ? seconds : 0);
 
-	return TRUE;
+	return ret;
 }
 
 /**
@@ -1008,21 +1391,13 @@ gtk_date_entry_set_date_strf (GtkDateEntry *date,
 void
 gtk_date_entry_set_date_tm (GtkDateEntry *date, const struct tm tmdate)
 {
-	GtkDateEntryPrivate *priv;
+	gint32 julian;
+	gint32 seconds;
 
 	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
 
-	priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
-
-	GDateTime *gdate = g_date_time_new_local ((gint)(tmdate.tm_year + 1900),
-	                                          (gint)(tmdate.tm_mon + 1),
-	                                          (gint)tmdate.tm_mday,
-	                                          (gint)tmdate.tm_hour,
-	                                          (gint)tmdate.tm_min,
-	                                          (gdouble)tmdate.tm_sec);
-	gtk_date_entry_set_date_gdatetime (date, (const GDateTime *)gdate);
-
-	g_date_time_unref (gdate);
+	_gtk_date_entry_tm_to_value (&tmdate, &julian, &seconds);
+	gtk_date_entry_set_value_julian (date, julian, seconds);
 }
 
 /**
@@ -1035,43 +1410,20 @@ gtk_date_entry_set_date_tm (GtkDateEntry *date, const struct tm tmdate)
 void
 gtk_date_entry_set_date_gdate (GtkDateEntry *date, const GDate *gdate)
 {
-	gint i;
-	gchar *txt;
+	gint32 julian;
 
 	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
 
-	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
-
-	txt = g_strdup ("");
-
-	if (gdate != NULL && g_date_valid (gdate))
+	julian = gdate != NULL && g_date_valid (gdate) ? g_date_get_julian (gdate) : 0;
+	if (gtk_date_entry_date_is (date, julian))
 		{
-			for (i = 0; i < 3; i++)
-				{
-					switch (priv->format[i])
-						{
-							case 'd':
-								txt = g_strconcat (txt, g_strdup_printf ("%02d", g_date_get_day (gdate)), NULL);
-								break;
-
-							case 'm':
-								txt = g_strconcat (txt, g_strdup_printf ("%02d", g_date_get_month (gdate)), NULL);
-								break;
-
-							case 'Y':
-								txt = g_strconcat (txt, g_strdup_printf ("%04d", g_date_get_year (gdate)), NULL);
-								break;
-						}
-
-					if (i < 2)
-						{
-							txt = g_strconcat (txt, priv->separator, NULL);
-						}
-				}
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
 		}
 
-	gtk_editable_set_position (GTK_EDITABLE (priv->day), 0);
-	gtk_entry_set_text (GTK_ENTRY (priv->day), txt);
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	gtk_date_entry_set_date_julian (date, julian);
 }
 
 /**
@@ -1084,41 +1436,14 @@ gtk_date_entry_set_date_gdate (GtkDateEntry *date, const GDate *gdate)
 void
 gtk_date_entry_set_date_gdatetime (GtkDateEntry *date, const GDateTime *gdatetime)
 {
-	GDate *gdate;
+	gint32 julian;
+	gint32 seconds;
 
 	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
 
-	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
-
-	gdate = NULL;
-	if (gdatetime != NULL)
-		{
-			gdate = g_date_new_dmy (g_date_time_get_day_of_month ((GDateTime *)gdatetime),
-			                        g_date_time_get_month ((GDateTime *)gdatetime),
-			                        g_date_time_get_year ((GDateTime *)gdatetime));
-		}
-
-	gtk_date_entry_set_date_gdate (date, gdate);
-
-	if (priv->time_is_visible && gdatetime != NULL)
-		{
-			gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnHours),
-			                           (gdouble)g_date_time_get_hour ((GDateTime *)gdatetime));
-			gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnMinutes),
-			                           (gdouble)g_date_time_get_minute ((GDateTime *)gdatetime));
-			if (priv->time_with_seconds)
-				{
-					gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnSeconds),
-					                           g_date_time_get_seconds ((GDateTime *)gdatetime));
-				}
-		}
-	else
-		{
-			gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnHours), 0.0);
-			gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnMinutes), 0.0);
-			gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnHours), 0.0);
-		}
-}
+	_gtk_date_entry_gdatetime_to_value (gdatetime, &julian, &seconds);
+	gtk_date_entry_set_value_julian (date, julian, seconds);
+}
 
 /**
  * gtk_date_entry_is_valid:
@@ -1131,229 +1456,1793 @@ gtk_date_entry_set_date_gdatetime (GtkDateEntry *date, const GDateTime *gdatetim
 gboolean
 gtk_date_entry_is_valid (GtkDateEntry *date)
 {
-	GDateTime *gdatetime;
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), FALSE);
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->value.valid;
+}
 
+/**
+ * gtk_date_entry_is_complete:
+ * @date: a #GtkDateEntry.
+ *
+ * Returns: TRUE if all the date's segments are filled, also if they don't
+ * make a valid date.
+ */
+gboolean
+gtk_date_entry_is_complete (GtkDateEntry *date)
+{
 	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), FALSE);
 
-	gdatetime = gtk_date_entry_get_gdatetime (date);
-	if (gdatetime != NULL)
-		{
-			return TRUE;
-		}
-	else
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->complete;
+}
+
+/**
+ * gtk_date_entry_get_julian:
+ * @date: a #GtkDateEntry.
+ *
+ * Returns: the @date's content as a GDate's julian day; 0 if it isn't a
+ * valid date.
+ */
+guint32
+gtk_date_entry_get_julian (GtkDateEntry *date)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), 0);
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->value.valid ? priv->value.julian : 0;
+}
+
+/**
+ * gtk_date_entry_get_seconds:
+ * @date: a #GtkDateEntry.
+ *
+ * Returns: the @date's time as seconds since midnight, as shown by the
+ * widget: 0 if the time isn't visible, and without the seconds if they
+ * aren't visible.
+ */
+gint32
+gtk_date_entry_get_seconds (GtkDateEntry *date)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), 0);
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (!priv->time_is_visible)
 		{
-			return FALSE;
+			return 0;
 		}
+
+	return priv->time_with_seconds ? priv->value.seconds : priv->value.seconds - priv->value.seconds % 60;
 }
 
 /**
- * gtk_date_entry_set_editable:
+ * gtk_date_entry_set_julian_seconds:
  * @date: a #GtkDateEntry.
- * @is_editable: TRUE if the user is allowed to edit the text in the widget.
+ * @julian: the date as a GDate's julian day; 0 to clear @date.
+ * @seconds: the time as seconds since midnight.
  *
- * Determines if the user can edit the text in the #GtkDateEntry widget or not.
+ * Sets the @date's content without building a GDate or a GDateTime.
  */
 void
-gtk_date_entry_set_editable (GtkDateEntry *date,
-                             gboolean is_editable)
+gtk_date_entry_set_julian_seconds (GtkDateEntry *date,
+                                   guint32 julian,
+                                   gint32 seconds)
 {
 	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+	g_return_if_fail (julian <= G_MAXINT32);
+	g_return_if_fail (seconds >= 0 && seconds < 86400);
+
+	gtk_date_entry_set_value_julian (date, julian, seconds);
+}
+
+/**
+ * gtk_date_entry_get_packed:
+ * @date: a #GtkDateEntry.
+ *
+ * Returns: the @date's content as GTK_DATE_ENTRY_PACK() of the julian day
+ * and the seconds; 0 if it isn't a valid date.
+ */
+gint64
+gtk_date_entry_get_packed (GtkDateEntry *date)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), 0);
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	gtk_editable_set_editable (GTK_EDITABLE (priv->day), is_editable);
-	gtk_widget_set_sensitive (priv->btnCalendar, is_editable);
-	gtk_widget_set_sensitive (priv->spnHours, is_editable);
-	gtk_widget_set_sensitive (priv->spnMinutes, is_editable);
-	gtk_widget_set_sensitive (priv->spnSeconds, is_editable);
+	if (!priv->value.valid)
+		{
+			return 0;
+		}
+
+	return GTK_DATE_ENTRY_PACK (priv->value.julian, priv->value.seconds);
 }
 
 /**
- * gtk_date_entry_set_editable_with_calendar:
- * @date:  a #GtkDateEntry.
- * @is_editable_with_calendar: TRUE if the user is allowed to edit the text
- * in the widget only from the calendar.
+ * gtk_date_entry_freeze_value_changed:
+ * @date: a #GtkDateEntry.
  *
- * Determines if the user can edit the text in the #GtkDateEntry widget only
- * from the calendar or not.
+ * Stops the emission of #GtkDateEntry::value-changed, and of the
+ * notifications, until gtk_date_entry_thaw_value_changed() is called as
+ * many times: many changes of the value emit at most one signal.
  */
 void
-gtk_date_entry_set_editable_with_calendar (GtkDateEntry *date,
-                                  gboolean is_editable_with_calendar)
+gtk_date_entry_freeze_value_changed (GtkDateEntry *date)
 {
 	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	gtk_editable_set_editable (GTK_EDITABLE (priv->day), !is_editable_with_calendar);
+	priv->freeze_count++;
+	g_object_freeze_notify (G_OBJECT (date));
 }
 
 /**
- * gtk_date_entry_set_calendar_button_visible:
+ * gtk_date_entry_thaw_value_changed:
  * @date: a #GtkDateEntry.
- * @is_visible: TRUE if the calendar's button must be visible.
- * 
- * Determines if the calendar's button is visible or not.
+ *
+ * Reverts gtk_date_entry_freeze_value_changed(); the last one emits
+ * #GtkDateEntry::value-changed if the value differs from the one of the
+ * last emission.
  */
 void
-gtk_date_entry_set_calendar_button_visible (GtkDateEntry *date,
-                                            gboolean is_visible)
+gtk_date_entry_thaw_value_changed (GtkDateEntry *date)
 {
 	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	if (is_visible)
-		{
-			gtk_widget_show (priv->btnCalendar);
-		}
-	else
+	g_return_if_fail (priv->freeze_count > 0);
+
+	priv->freeze_count--;
+	g_object_thaw_notify (G_OBJECT (date));
+
+	gtk_date_entry_emit_value_changed (date);
+}
+
+/**
+ * gtk_date_entry_get_unix_usec:
+ * @date: a #GtkDateEntry.
+ *
+ * Returns: the @date's content, read in the @date's time zone, as
+ * microseconds since 1970-01-01 00:00:00 UTC; G_MININT64 if it isn't a
+ * valid date.
+ */
+gint64
+gtk_date_entry_get_unix_usec (GtkDateEntry *date)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), G_MININT64);
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (!priv->value.valid)
 		{
-			gtk_widget_hide (priv->btnCalendar);
+			return G_MININT64;
 		}
+
+	return _gtk_date_entry_value_to_unix_usec (gtk_date_entry_get_conversion_zone (date),
+	                                           priv->value.julian,
+	                                           gtk_date_entry_get_seconds (date));
 }
 
 /**
- * gtk_date_entry_set_date_visible:
+ * gtk_date_entry_set_unix_usec:
  * @date: a #GtkDateEntry.
- * @is_visible: TRUE if the date must be visible.
- * 
- * Determines if the date is visible or not.
+ * @usec: microseconds since 1970-01-01 00:00:00 UTC; G_MININT64 to clear
+ * @date.
+ *
+ * Sets the @date's content from a unix time, shown in the @date's time zone;
+ * the fraction of second is dropped.
  */
 void
-gtk_date_entry_set_date_visible (GtkDateEntry *date,
-                                 gboolean is_visible)
+gtk_date_entry_set_unix_usec (GtkDateEntry *date,
+                              gint64 usec)
+{
+	gint32 julian;
+	gint32 seconds;
+
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	_gtk_date_entry_unix_usec_to_value (gtk_date_entry_get_conversion_zone (date),
+	                                    usec, &julian, &seconds);
+	gtk_date_entry_set_value_julian (date, julian, seconds);
+}
+
+/**
+ * gtk_date_entry_set_timezone:
+ * @date: a #GtkDateEntry.
+ * @tz: (allow-none): a #GTimeZone; NULL for the local time zone.
+ *
+ * Sets the time zone used to convert the shown date and time from and to
+ * absolute times (#GDateTime and unix time); it turns off the UTC mode.
+ * The shown date and time don't change.
+ */
+void
+gtk_date_entry_set_timezone (GtkDateEntry *date,
+                             GTimeZone *tz)
 {
 	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	priv->date_is_visible = is_visible;
+	if (tz == priv->tz && !priv->utc)
+		{
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
+		}
 
-	gtk_date_entry_set_calendar_button_visible (date, priv->date_is_visible);
+	GTK_DATE_ENTRY_COUNT (updates_applied);
 
-	if (priv->date_is_visible)
+	if (tz != NULL)
 		{
-			gtk_widget_show (priv->day);
+			g_time_zone_ref (tz);
 		}
-	else
+	if (priv->tz != NULL)
 		{
-			gtk_widget_hide (priv->day);
+			g_time_zone_unref (priv->tz);
+		}
+	priv->tz = tz;
 
-			gtk_date_entry_set_date_gdatetime (date, NULL);
+	g_object_notify (G_OBJECT (date), "timezone");
+	if (priv->utc)
+		{
+			priv->utc = FALSE;
+			g_object_notify (G_OBJECT (date), "utc");
 		}
+	g_object_notify (G_OBJECT (date), "unix-usec");
 }
 
 /**
- * gtk_date_entry_is_date_visible:
+ * gtk_date_entry_get_timezone:
  * @date: a #GtkDateEntry.
- * 
- * Returns: #TRUE or #FALSE if date part is visible or not.
+ *
+ * Returns: (transfer none): the time zone set with
+ * gtk_date_entry_set_timezone(); NULL if @date uses the local time zone or
+ * UTC.
+ */
+GTimeZone
+*gtk_date_entry_get_timezone (GtkDateEntry *date)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), NULL);
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->utc ? NULL : priv->tz;
+}
+
+/**
+ * gtk_date_entry_set_utc:
+ * @date: a #GtkDateEntry.
+ * @utc: TRUE if the shown date and time are in UTC.
+ *
+ * In UTC mode the conversions from and to absolute times don't look up any
+ * time zone.
+ */
+void
+gtk_date_entry_set_utc (GtkDateEntry *date,
+                        gboolean utc)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->utc == !!utc)
+		{
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
+		}
+
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	priv->utc = !!utc;
+
+	g_object_notify (G_OBJECT (date), "utc");
+	g_object_notify (G_OBJECT (date), "timezone");
+	g_object_notify (G_OBJECT (date), "unix-usec");
+}
+
+/**
+ * gtk_date_entry_is_utc:
+ * @date: a #GtkDateEntry.
+ *
+ * Returns: TRUE if the shown date and time are in UTC.
  */
 gboolean
-gtk_date_entry_is_date_visible (GtkDateEntry *date)
+gtk_date_entry_is_utc (GtkDateEntry *date)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), FALSE);
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->utc;
+}
+
+/**
+ * gtk_date_entry_set_min_date:
+ * @date: a #GtkDateEntry.
+ * @julian: the first allowed date, as a GDate's julian day; 0 for no bound.
+ *
+ * The dates before @julian aren't valid: the setters move them to @julian,
+ * the typed ones make the entry not valid, and they can't be chosen from
+ * the calendar. A value before @julian is moved to it.
+ */
+void
+gtk_date_entry_set_min_date (GtkDateEntry *date,
+                             guint32 julian)
 {
 	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	return priv->date_is_visible;
+	gtk_date_entry_set_bounds (date, julian, priv->max_julian);
 }
 
 /**
- * gtk_date_entry_set_time_visible:
+ * gtk_date_entry_get_min_date:
  * @date: a #GtkDateEntry.
- * @is_visible: TRUE if the time must be visible.
- * 
- * Determines if the time is visible or not.
+ *
+ * Returns: the first allowed date, as a GDate's julian day; 0 if there
+ * isn't a bound.
+ */
+guint32
+gtk_date_entry_get_min_date (GtkDateEntry *date)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), 0);
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->min_julian;
+}
+
+/**
+ * gtk_date_entry_set_max_date:
+ * @date: a #GtkDateEntry.
+ * @julian: the last allowed date, as a GDate's julian day; 0 for no bound.
+ *
+ * The same as gtk_date_entry_set_min_date(), for the dates after @julian.
  */
 void
-gtk_date_entry_set_time_visible (GtkDateEntry *date,
-                                 gboolean is_visible)
+gtk_date_entry_set_max_date (GtkDateEntry *date,
+                             guint32 julian)
 {
 	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	priv->time_is_visible = is_visible;
-	if (priv->time_is_visible)
-		{
-			gtk_widget_show (priv->spnHours);
-			gtk_widget_show (priv->lblMinutes);
-			gtk_widget_show (priv->spnMinutes);
-			if (priv->time_with_seconds)
-				{
-					gtk_widget_show (priv->lblSeconds);
-					gtk_widget_show (priv->spnSeconds);
-				}
-			else
-				{
-					gtk_widget_hide (priv->lblSeconds);
-					gtk_widget_hide (priv->spnSeconds);
+	gtk_date_entry_set_bounds (date, priv->min_julian, julian);
+}
 
-					gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnSeconds), 0.0);
-				}
+/**
+ * gtk_date_entry_get_max_date:
+ * @date: a #GtkDateEntry.
+ *
+ * Returns: the last allowed date, as a GDate's julian day; 0 if there
+ * isn't a bound.
+ */
+guint32
+gtk_date_entry_get_max_date (GtkDateEntry *date)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), 0);
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->max_julian;
+}
+
+/**
+ * gtk_date_entry_set_calendar_rules:
+ * @date: a #GtkDateEntry.
+ * @rules: (allow-none): a #GtkDateCalendarRules; NULL to allow all days.
+ *
+ * The days that aren't business days for @rules make the entry not valid,
+ * and they can't be chosen from the calendar, where the business days are
+ * marked. The same @rules can be shared by many entries.
+ */
+void
+gtk_date_entry_set_calendar_rules (GtkDateEntry *date,
+                                   GtkDateCalendarRules *rules)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+	g_return_if_fail (rules == NULL || GTK_IS_DATE_CALENDAR_RULES (rules));
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->rules == rules)
+		{
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
 		}
-	else
+
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	if (priv->rules != NULL)
 		{
-			gtk_widget_hide (priv->spnHours);
-			gtk_widget_hide (priv->lblMinutes);
-			gtk_widget_hide (priv->spnMinutes);
-			gtk_widget_hide (priv->lblSeconds);
-			gtk_widget_hide (priv->spnSeconds);
+			g_signal_handler_disconnect (priv->rules, priv->rules_changed_id);
+			g_object_unref (priv->rules);
+		}
 
-			gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnHours), 0.0);
-			gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnMinutes), 0.0);
-			gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnSeconds), 0.0);
+	priv->rules = rules;
+	priv->rules_changed_id = 0;
+	if (rules != NULL)
+		{
+			g_object_ref (rules);
+			priv->rules_changed_id = g_signal_connect (rules, "changed",
+			                                           G_CALLBACK (rules_on_changed), date);
 		}
+
+	g_object_freeze_notify (G_OBJECT (date));
+	g_object_notify (G_OBJECT (date), "calendar-rules");
+	gtk_date_entry_revalidate (date);
+	g_object_thaw_notify (G_OBJECT (date));
 }
 
 /**
- * gtk_date_entry_is_time_visible:
+ * gtk_date_entry_get_calendar_rules:
  * @date: a #GtkDateEntry.
- * 
- * Returns: #TRUE or #FALSE if time part is visible or not.
+ *
+ * Returns: (transfer none): the #GtkDateCalendarRules set with
+ * gtk_date_entry_set_calendar_rules(); NULL if all days are allowed.
+ */
+GtkDateCalendarRules
+*gtk_date_entry_get_calendar_rules (GtkDateEntry *date)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), NULL);
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->rules;
+}
+
+/**
+ * gtk_date_entry_next_business_day:
+ * @date: a #GtkDateEntry.
+ *
+ * Moves @date to the first business day after its date, keeping the time;
+ * without calendar's rules, to the next day.
+ *
+ * Returns: FALSE if @date isn't valid, or if the next business day is
+ * after "max-date".
  */
 gboolean
-gtk_date_entry_is_time_visible (GtkDateEntry *date)
+gtk_date_entry_next_business_day (GtkDateEntry *date)
 {
-	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+	guint32 julian;
+
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY (date), FALSE);
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (!priv->value.valid)
+		{
+			return FALSE;
+		}
+
+	julian = _gtk_date_entry_next_business_day (priv->min_julian,
+	                                            priv->max_julian,
+	                                            priv->rules,
+	                                            priv->value.julian);
+	if (julian == 0)
+		{
+			return FALSE;
+		}
+
+	gtk_date_entry_set_value_julian (date, julian, priv->value.seconds);
+
+	return TRUE;
+}
+
+/**
+ * gtk_date_entry_set_editable:
+ * @date: a #GtkDateEntry.
+ * @is_editable: TRUE if the user is allowed to edit the text in the widget.
+ *
+ * Determines if the user can edit the text in the #GtkDateEntry widget or not.
+ */
+void
+gtk_date_entry_set_editable (GtkDateEntry *date,
+                             gboolean is_editable)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (gtk_editable_get_editable (GTK_EDITABLE (priv->day)) == !!is_editable
+	    && gtk_widget_get_sensitive (priv->btnCalendar) == !!is_editable)
+		{
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
+		}
+
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	gtk_editable_set_editable (GTK_EDITABLE (priv->day), is_editable);
+	gtk_widget_set_sensitive (priv->btnCalendar, is_editable);
+	if (priv->spnHours != NULL)
+		{
+			gtk_widget_set_sensitive (priv->spnHours, is_editable);
+			gtk_widget_set_sensitive (priv->spnMinutes, is_editable);
+			gtk_widget_set_sensitive (priv->spnSeconds, is_editable);
+		}
+}
+
+/**
+ * gtk_date_entry_set_editable_with_calendar:
+ * @date:  a #GtkDateEntry.
+ * @is_editable_with_calendar: TRUE if the user is allowed to edit the text
+ * in the widget only from the calendar.
+ *
+ * Determines if the user can edit the text in the #GtkDateEntry widget only
+ * from the calendar or not.
+ */
+void
+gtk_date_entry_set_editable_with_calendar (GtkDateEntry *date,
+                                  gboolean is_editable_with_calendar)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (gtk_editable_get_editable (GTK_EDITABLE (priv->day)) == !is_editable_with_calendar)
+		{
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
+		}
+
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	gtk_editable_set_editable (GTK_EDITABLE (priv->day), !is_editable_with_calendar);
+}
+
+/**
+ * gtk_date_entry_set_calendar_button_visible:
+ * @date: a #GtkDateEntry.
+ * @is_visible: TRUE if the calendar's button must be visible.
+ * 
+ * Determines if the calendar's button is visible or not.
+ */
+void
+gtk_date_entry_set_calendar_button_visible (GtkDateEntry *date,
+                                            gboolean is_visible)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (gtk_widget_get_visible (priv->btnCalendar) == !!is_visible)
+		{
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
+		}
+
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	if (is_visible)
+		{
+			gtk_widget_show (priv->btnCalendar);
+		}
+	else
+		{
+			gtk_widget_hide (priv->btnCalendar);
+		}
+}
+
+/**
+ * gtk_date_entry_set_date_visible:
+ * @date: a #GtkDateEntry.
+ * @is_visible: TRUE if the date must be visible.
+ * 
+ * Determines if the date is visible or not.
+ */
+void
+gtk_date_entry_set_date_visible (GtkDateEntry *date,
+                                 gboolean is_visible)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->date_is_visible == !!is_visible)
+		{
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
+		}
+
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	priv->date_is_visible = !!is_visible;
+
+	gtk_date_entry_set_calendar_button_visible (date, priv->date_is_visible);
+
+	if (priv->date_is_visible)
+		{
+			gtk_widget_show (priv->day);
+		}
+	else
+		{
+			gtk_widget_hide (priv->day);
+
+			gtk_date_entry_set_date_gdatetime (date, NULL);
+		}
+}
+
+/**
+ * gtk_date_entry_is_date_visible:
+ * @date: a #GtkDateEntry.
+ * 
+ * Returns: #TRUE or #FALSE if date part is visible or not.
+ */
+gboolean
+gtk_date_entry_is_date_visible (GtkDateEntry *date)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->date_is_visible;
+}
+
+/**
+ * gtk_date_entry_set_time_visible:
+ * @date: a #GtkDateEntry.
+ * @is_visible: TRUE if the time must be visible.
+ * 
+ * Determines if the time is visible or not.
+ */
+void
+gtk_date_entry_set_time_visible (GtkDateEntry *date,
+                                 gboolean is_visible)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->time_is_visible == !!is_visible)
+		{
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
+		}
+
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	priv->time_is_visible = !!is_visible;
+	gtk_date_entry_apply_time_visible (date);
+}
+
+/* applies time_is_visible and time_with_seconds to the value and to the
+ * time's widgets */
+static void
+gtk_date_entry_apply_time_visible (GtkDateEntry *date)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->time_is_visible)
+		{
+			if (!priv->time_with_seconds)
+				{
+					gtk_date_entry_set_time_seconds (date, priv->value.seconds - priv->value.seconds % 60);
+				}
+
+			/* before being in a container the widgets can wait */
+			if (priv->spnHours == NULL
+			    && gtk_widget_get_parent (GTK_WIDGET (date)) != NULL)
+				{
+					gtk_date_entry_build_time (date);
+				}
+		}
+	else
+		{
+			gtk_date_entry_set_time_seconds (date, 0);
+		}
+
+	gtk_date_entry_show_time (date);
+}
+
+/**
+ * gtk_date_entry_is_time_visible:
+ * @date: a #GtkDateEntry.
+ * 
+ * Returns: #TRUE or #FALSE if time part is visible or not.
+ */
+gboolean
+gtk_date_entry_is_time_visible (GtkDateEntry *date)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->time_is_visible;
+}
+
+/* PRIVATE */
+/* returns the interned @format without spaces, NULL if it isn't exactly
+ * one day, one month and one year */
+const gchar
+*_gtk_date_entry_intern_format (const gchar *format)
+{
+	gchar *_format;
+	const gchar *ret;
+
+	if (format == NULL)
+		{
+			return NULL;
+		}
+
+	_format = g_strstrip (g_strdup (format));
+	if (strlen (_format) != 3
+	    || strchr (_format, 'd') == NULL
+	    || strchr (_format, 'm') == NULL
+	    || strchr (_format, 'Y') == NULL)
+		{
+			ret = NULL;
+		}
+	else
+		{
+			ret = g_intern_string (_format);
+		}
+	g_free (_format);
+
+	return ret;
+}
+
+/* returns the interned @separator without spaces, NULL if it isn't one
+ * char */
+const gchar
+*_gtk_date_entry_intern_separator (const gchar *separator)
+{
+	gchar *_separator;
+	const gchar *ret;
+
+	if (separator == NULL)
+		{
+			return NULL;
+		}
+
+	_separator = g_strstrip (g_strdup (separator));
+	ret = strlen (_separator) == 1 ? g_intern_string (_separator) : NULL;
+	g_free (_separator);
+
+	return ret;
+}
+
+static void
+gtk_date_entry_compile_format (GtkDateEntry *date)
+{
+	GtkDateFormat *fmt;
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	/* most entries keep the locale's format: it is shared */
+	fmt = _gtk_date_entry_ref_locale_format ();
+	if (gtk_date_format_get_format (fmt) != priv->format
+	    || gtk_date_format_get_separator (fmt) != priv->separator
+	    || gtk_date_format_get_time_separator (fmt) != priv->time_separator)
+		{
+			gtk_date_format_unref (fmt);
+			fmt = gtk_date_format_new (priv->format, priv->separator, priv->time_separator);
+		}
+
+	if (priv->compiled != NULL)
+		{
+			gtk_date_format_unref (priv->compiled);
+		}
+	priv->compiled = fmt;
+
+	/* the compiled format falls back to default separators */
+	priv->separator = gtk_date_format_get_separator (priv->compiled);
+	priv->time_separator = gtk_date_format_get_time_separator (priv->compiled);
+}
+
+/*
+ * returns the compiled format for gtk_date_entry_get_strf and
+ * gtk_date_entry_set_date_strf; the last one is kept, so repeated calls
+ * with the same format don't compile it again
+ */
+static GtkDateFormat
+*gtk_date_entry_get_strf_format (GtkDateEntry *date,
+                                 const gchar *format,
+                                 const gchar *separator,
+                                 const gchar *time_separator)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (format == NULL) format = priv->format;
+	if (separator == NULL) separator = priv->separator;
+	if (time_separator == NULL) time_separator = priv->time_separator;
+
+	if (format == priv->format
+	    && separator == priv->separator
+	    && time_separator == priv->time_separator)
+		{
+			return priv->compiled;
+		}
+
+	if (priv->strf_format != NULL)
+		{
+			if (g_strcmp0 (gtk_date_format_get_format (priv->strf_format), format) == 0
+			    && g_strcmp0 (gtk_date_format_get_separator (priv->strf_format), separator) == 0
+			    && g_strcmp0 (gtk_date_format_get_time_separator (priv->strf_format), time_separator) == 0)
+				{
+					return priv->strf_format;
+				}
+			gtk_date_format_unref (priv->strf_format);
+		}
+
+	priv->strf_format = gtk_date_format_new (format, separator, time_separator);
+
+	return priv->strf_format;
+}
+
+/* the format of get_sql and set_sql, also used by GtkDateField */
+GtkDateFormat
+*_gtk_date_entry_get_sql_format (void)
+{
+	static GtkDateFormat *sql_format = NULL;
+
+	if (g_once_init_enter (&sql_format))
+		{
+			g_once_init_leave (&sql_format, gtk_date_format_new ("YmdHMS", "-", ":"));
+		}
+
+	return sql_format;
+}
+
+GTimeZone
+*_gtk_date_entry_get_local_time_zone (void)
+{
+	if (local_tz == NULL)
+		{
+			local_tz = g_time_zone_new_local ();
+		}
+
+	return local_tz;
+}
+
+/* the entry's time zone, not referenced */
+static GTimeZone
+*gtk_date_entry_get_time_zone (GtkDateEntry *date)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->tz != NULL ? priv->tz : _gtk_date_entry_get_local_time_zone ();
+}
+
+/* the zone given to the shared conversions: NULL in UTC mode */
+static GTimeZone
+*gtk_date_entry_get_conversion_zone (GtkDateEntry *date)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return priv->utc ? NULL : gtk_date_entry_get_time_zone (date);
+}
+
+/* @local is a shown date and time as seconds since 1970-01-01 00:00:00;
+ * a NULL @tz is UTC */
+gint64
+_gtk_date_entry_local_to_utc (GTimeZone *tz,
+                              gint64 local)
+{
+	gint interval;
+
+	if (tz == NULL)
+		{
+			return local;
+		}
+
+	/* same choice of g_date_time_new () for times skipped or repeated */
+	interval = g_time_zone_adjust_time (tz, G_TIME_TYPE_DAYLIGHT, &local);
+	local -= g_time_zone_get_offset (tz, interval);
+
+	return local;
+}
+
+gint64
+_gtk_date_entry_utc_to_local (GTimeZone *tz,
+                              gint64 utc)
+{
+	gint interval;
+
+	if (tz == NULL)
+		{
+			return utc;
+		}
+
+	interval = g_time_zone_find_interval (tz, G_TIME_TYPE_UNIVERSAL, utc);
+	utc += g_time_zone_get_offset (tz, interval);
+
+	return utc;
+}
+
+gint64
+_gtk_date_entry_value_to_unix_usec (GTimeZone *tz,
+                                    guint32 julian,
+                                    gint32 seconds)
+{
+	gint64 local;
+
+	local = (gint64)((gint32)julian - GTK_DATE_ENTRY_JULIAN_1970) * 86400 + seconds;
+
+	return _gtk_date_entry_local_to_utc (tz, local) * G_USEC_PER_SEC;
+}
+
+/* G_MININT64, or a time outside GDate's range, gives a julian day of 0 */
+void
+_gtk_date_entry_unix_usec_to_value (GTimeZone *tz,
+                                    gint64 usec,
+                                    gint32 *julian,
+                                    gint32 *seconds)
+{
+	gint64 secs;
+	gint64 days;
+
+	*julian = 0;
+	*seconds = 0;
+
+	if (usec == G_MININT64)
+		{
+			return;
+		}
+
+	/* floor divisions, for times before 1970 */
+	secs = usec / G_USEC_PER_SEC - (usec % G_USEC_PER_SEC < 0);
+	secs = _gtk_date_entry_utc_to_local (tz, secs);
+
+	days = secs / 86400 - (secs % 86400 < 0);
+	if (days + GTK_DATE_ENTRY_JULIAN_1970 < 1
+	    || days + GTK_DATE_ENTRY_JULIAN_1970 > G_MAXINT32)
+		{
+			return;
+		}
+
+	*julian = (gint32)(days + GTK_DATE_ENTRY_JULIAN_1970);
+	*seconds = (gint32)(secs - days * 86400);
+}
+
+struct tm
+*_gtk_date_entry_value_to_tm (guint32 julian,
+                              gint32 seconds)
+{
+	struct tm *tm;
+	GDate gdate;
+
+	tm = g_malloc0 (sizeof (struct tm));
+
+	g_date_clear (&gdate, 1);
+	g_date_set_julian (&gdate, julian);
+	g_date_to_struct_tm (&gdate, tm);
+
+	tm->tm_hour = seconds / 3600;
+	tm->tm_min = (seconds / 60) % 60;
+	tm->tm_sec = seconds % 60;
+
+	return tm;
+}
+
+/* a date, or a time, out of range gives a julian day of 0 */
+void
+_gtk_date_entry_tm_to_value (const struct tm *tmdate,
+                             gint32 *julian,
+                             gint32 *seconds)
+{
+	GDate gdate;
+
+	*julian = 0;
+	if (g_date_valid_dmy ((GDateDay)tmdate->tm_mday,
+	                      (GDateMonth)(tmdate->tm_mon + 1),
+	                      (GDateYear)(tmdate->tm_year + 1900))
+	    && tmdate->tm_hour >= 0 && tmdate->tm_hour < 24
+	    && tmdate->tm_min >= 0 && tmdate->tm_min < 60
+	    && tmdate->tm_sec >= 0 && tmdate->tm_sec < 60)
+		{
+			g_date_clear (&gdate, 1);
+			g_date_set_dmy (&gdate,
+			                (GDateDay)tmdate->tm_mday,
+			                (GDateMonth)(tmdate->tm_mon + 1),
+			                (GDateYear)(tmdate->tm_year + 1900));
+			*julian = g_date_get_julian (&gdate);
+		}
+
+	*seconds = tmdate->tm_hour * 3600 + tmdate->tm_min * 60 + tmdate->tm_sec;
+}
+
+/* a NULL @tz is UTC */
+GDateTime
+*_gtk_date_entry_value_to_gdatetime (GTimeZone *tz,
+                                     guint32 julian,
+                                     gint32 seconds)
+{
+	GDate gdate;
+
+	g_date_clear (&gdate, 1);
+	g_date_set_julian (&gdate, julian);
+
+	if (tz == NULL)
+		{
+			return g_date_time_new_utc (g_date_get_year (&gdate),
+			                            g_date_get_month (&gdate),
+			                            g_date_get_day (&gdate),
+			                            seconds / 3600,
+			                            (seconds / 60) % 60,
+			                            (gdouble)(seconds % 60));
+		}
+
+	return g_date_time_new (tz,
+	                        g_date_get_year (&gdate),
+	                        g_date_get_month (&gdate),
+	                        g_date_get_day (&gdate),
+	                        seconds / 3600,
+	                        (seconds / 60) % 60,
+	                        (gdouble)(seconds % 60));
+}
+
+/* the shown date and time of @gdatetime, in its own zone; NULL gives a
+ * julian day of 0 */
+void
+_gtk_date_entry_gdatetime_to_value (const GDateTime *gdatetime,
+                                    gint32 *julian,
+                                    gint32 *seconds)
+{
+	GDate gdate;
+
+	*julian = 0;
+	*seconds = 0;
+	if (gdatetime == NULL)
+		{
+			return;
+		}
+
+	g_date_clear (&gdate, 1);
+	g_date_set_dmy (&gdate,
+	                g_date_time_get_day_of_month ((GDateTime *)gdatetime),
+	                g_date_time_get_month ((GDateTime *)gdatetime),
+	                g_date_time_get_year ((GDateTime *)gdatetime));
+	*julian = g_date_get_julian (&gdate);
+	*seconds = g_date_time_get_hour ((GDateTime *)gdatetime) * 3600
+	           + g_date_time_get_minute ((GDateTime *)gdatetime) * 60
+	           + g_date_time_get_second ((GDateTime *)gdatetime);
+}
+
+static void
+gtk_date_entry_build_popup (void)
+{
+	popup.window = gtk_window_new (GTK_WINDOW_POPUP);
+	gtk_window_set_resizable (GTK_WINDOW (popup.window), FALSE);
+	gtk_container_set_border_width (GTK_CONTAINER (popup.window), 3);
+
+	gtk_widget_set_events (popup.window,
+	                       gtk_widget_get_events (popup.window) | GDK_KEY_PRESS_MASK);
+
+	g_signal_connect (popup.window, "delete_event",
+	                  G_CALLBACK (delete_popup), NULL);
+	g_signal_connect (popup.window, "key_press_event",
+	                  G_CALLBACK (key_press_popup), NULL);
+	g_signal_connect (popup.window, "button_press_event",
+	                  G_CALLBACK (button_press_popup), NULL);
+
+	popup.calendar = gtk_calendar_new ();
+	gtk_container_add (GTK_CONTAINER (popup.window), popup.calendar);
+	gtk_widget_show (popup.calendar);
+
+	g_signal_connect (G_OBJECT (popup.calendar), "day-selected",
+	                  G_CALLBACK (calendar_on_day_selected), NULL);
+	g_signal_connect (G_OBJECT (popup.calendar), "day-selected-double-click",
+	                  G_CALLBACK (calendar_on_day_selected_double_click), NULL);
+	g_signal_connect (G_OBJECT (popup.calendar), "month-changed",
+	                  G_CALLBACK (calendar_on_month_changed), NULL);
+}
+
+static void
+gtk_date_entry_destroy_popup (void)
+{
+	if (popup.timeout_id != 0)
+		{
+			g_source_remove (popup.timeout_id);
+			popup.timeout_id = 0;
+		}
+
+	if (popup.window != NULL)
+		{
+			gtk_widget_destroy (popup.window);
+			popup.window = NULL;
+			popup.calendar = NULL;
+		}
+}
+
+static void
+gtk_date_entry_change_mask (GtkDateEntry *date)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	/* the segments moved */
+	priv->seg_dirty = 0x7;
+
+	gtk_masked_entry_set_mask (GTK_MASKED_ENTRY (priv->day),
+	                           gtk_date_format_get_mask (priv->compiled));
+	gtk_entry_set_width_chars (GTK_ENTRY (priv->day),
+	                           gtk_date_format_get_width (priv->compiled));
+}
+
+/* sets only the date part; 0 clears it */
+static void
+gtk_date_entry_set_date_julian (GtkDateEntry *date,
+                                gint32 julian)
+{
+	gchar txt[32];
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	julian = gtk_date_entry_clamp_julian (date, julian);
+	gtk_date_format_format_date (priv->compiled, julian, txt, sizeof (txt));
+
+	/* setting the text clears it first */
+	gtk_date_entry_freeze_value_changed (date);
+	gtk_editable_set_position (GTK_EDITABLE (priv->day), 0);
+	gtk_entry_set_text (GTK_ENTRY (priv->day), txt);
+	priv->date_cleared = julian <= 0;
+	gtk_date_entry_thaw_value_changed (date);
+}
+
+/* sets the date and the time part; a julian day of 0 clears both */
+static void
+gtk_date_entry_set_value_julian (GtkDateEntry *date,
+                                 gint32 julian,
+                                 gint32 seconds)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	julian = gtk_date_entry_clamp_julian (date, julian);
+	if (!priv->time_is_visible || julian <= 0)
+		{
+			seconds = 0;
+		}
+	else if (!priv->time_with_seconds)
+		{
+			seconds -= seconds % 60;
+		}
+
+	/* rebinding to the same value doesn't touch the widgets */
+	if (gtk_date_entry_date_is (date, julian)
+	    && priv->value.seconds == (guint)seconds)
+		{
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
+		}
+
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	gtk_date_entry_freeze_value_changed (date);
+
+	if (!gtk_date_entry_date_is (date, julian))
+		{
+			gtk_date_entry_set_date_julian (date, julian);
+		}
+	gtk_date_entry_set_time_seconds (date, seconds);
+
+	gtk_date_entry_thaw_value_changed (date);
+}
+
+/* TRUE if the shown date is @julian: the same valid date, or a cleared
+ * text for 0 */
+static gboolean
+gtk_date_entry_date_is (GtkDateEntry *date,
+                        gint32 julian)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (julian <= 0)
+		{
+			return priv->date_cleared;
+		}
+
+	return priv->value.valid && priv->value.julian == (guint32)julian;
+}
+
+/* moves a valid @julian inside the allowed dates */
+static gint32
+gtk_date_entry_clamp_julian (GtkDateEntry *date,
+                             gint32 julian)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return _gtk_date_entry_clamp_julian (priv->min_julian, priv->max_julian, julian);
+}
+
+/* bounds of 0 are open */
+gint32
+_gtk_date_entry_clamp_julian (guint32 min_julian,
+                              guint32 max_julian,
+                              gint32 julian)
+{
+	if (julian <= 0)
+		{
+			return julian;
+		}
+	if (min_julian != 0 && (guint32)julian < min_julian)
+		{
+			return min_julian;
+		}
+	if (max_julian != 0 && (guint32)julian > max_julian)
+		{
+			return max_julian;
+		}
+
+	return julian;
+}
+
+static void
+gtk_date_entry_set_bounds (GtkDateEntry *date,
+                           guint32 min_julian,
+                           guint32 max_julian)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->min_julian == min_julian
+	    && priv->max_julian == max_julian)
+		{
+			GTK_DATE_ENTRY_COUNT (updates_skipped);
+			return;
+		}
+
+	GTK_DATE_ENTRY_COUNT (updates_applied);
+
+	g_object_freeze_notify (G_OBJECT (date));
+
+	if (priv->min_julian != min_julian)
+		{
+			priv->min_julian = min_julian;
+			g_object_notify (G_OBJECT (date), "min-date");
+		}
+	if (priv->max_julian != max_julian)
+		{
+			priv->max_julian = max_julian;
+			g_object_notify (G_OBJECT (date), "max-date");
+		}
+
+	if (priv->value.valid)
+		{
+			gtk_date_entry_set_value_julian (date, priv->value.julian, priv->value.seconds);
+		}
+	gtk_date_entry_revalidate (date);
+
+	g_object_thaw_notify (G_OBJECT (date));
+}
+
+/* TRUE if @julian is in the bounds and is a business day */
+static gboolean
+gtk_date_entry_is_allowed (GtkDateEntry *date,
+                           guint32 julian)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	return _gtk_date_entry_is_allowed (priv->min_julian, priv->max_julian, priv->rules, julian);
+}
+
+gboolean
+_gtk_date_entry_is_allowed (guint32 min_julian,
+                            guint32 max_julian,
+                            GtkDateCalendarRules *rules,
+                            guint32 julian)
+{
+	return _gtk_date_entry_clamp_julian (min_julian, max_julian, julian) == (gint32)julian
+	       && (rules == NULL
+	           || gtk_date_calendar_rules_is_business_day (rules, julian));
+}
+
+/* the first allowed business day after @julian, without rules the next
+ * day; 0 if there isn't one */
+guint32
+_gtk_date_entry_next_business_day (guint32 min_julian,
+                                   guint32 max_julian,
+                                   GtkDateCalendarRules *rules,
+                                   guint32 julian)
+{
+	if (rules != NULL)
+		{
+			julian = gtk_date_calendar_rules_next_business_day (rules, julian);
+		}
+	else
+		{
+			julian = julian + 1;
+		}
+
+	/* before "min-date" the first allowed day is searched again */
+	if (julian != 0 && min_julian != 0 && julian < min_julian)
+		{
+			julian = min_julian;
+			if (rules != NULL
+			    && !gtk_date_calendar_rules_is_business_day (rules, julian))
+				{
+					julian = gtk_date_calendar_rules_next_business_day (rules, julian);
+				}
+		}
+
+	if (julian == 0 || !_gtk_date_entry_is_allowed (min_julian, max_julian, rules, julian))
+		{
+			return 0;
+		}
+
+	return julian;
+}
+
+/* after a change of the allowed days: a complete date can become valid,
+ * or not valid, and the calendar's marks change */
+static void
+gtk_date_entry_revalidate (GtkDateEntry *date)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->complete)
+		{
+			priv->seg_dirty = 0x7;
+			day_on_changed (GTK_EDITABLE (priv->day), date);
+		}
+
+	if (popup.owner == date)
+		{
+			gtk_date_entry_mark_calendar ();
+		}
+}
+
+/* ends the cell's editing started by gtk_cell_editable_start_editing() */
+static void
+gtk_date_entry_finish_editing (GtkDateEntry *date,
+                               gboolean canceled)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (!priv->editing)
+		{
+			return;
+		}
+
+	priv->editing = FALSE;
+	if (priv->focus_check_id != 0)
+		{
+			g_source_remove (priv->focus_check_id);
+			priv->focus_check_id = 0;
+		}
+
+	if (popup.owner == date)
+		{
+			hide_popup (GTK_WIDGET (date));
+		}
+
+	if (priv->editing_canceled != canceled)
+		{
+			priv->editing_canceled = canceled;
+			g_object_notify (G_OBJECT (date), "editing-canceled");
+		}
+
+	gtk_cell_editable_editing_done (GTK_CELL_EDITABLE (date));
+	gtk_cell_editable_remove_widget (GTK_CELL_EDITABLE (date));
+}
+
+/* ends the popup and the cell's editing without any signal, for an entry
+ * that is reused */
+void
+_gtk_date_entry_stop_editing (GtkDateEntry *date)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (popup.owner == date)
+		{
+			hide_popup (GTK_WIDGET (date));
+		}
+
+	priv->editing = FALSE;
+	if (priv->focus_check_id != 0)
+		{
+			g_source_remove (priv->focus_check_id);
+			priv->focus_check_id = 0;
+		}
+}
+
+/* after a part lost the focus: the editing ends if the focus isn't in
+ * another part, nor in the calendar's popup */
+static gboolean
+gtk_date_entry_check_focus (gpointer user_data)
+{
+	GtkWidget *toplevel;
+	GtkWidget *focus;
+
+	GtkDateEntry *date = (GtkDateEntry *)user_data;
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	priv->focus_check_id = 0;
+
+	if (popup.owner == date)
+		{
+			return FALSE;
+		}
+
+	toplevel = gtk_widget_get_toplevel (GTK_WIDGET (date));
+	focus = GTK_IS_WINDOW (toplevel) ? gtk_window_get_focus (GTK_WINDOW (toplevel)) : NULL;
+	if (focus == NULL
+	    || !gtk_widget_is_ancestor (focus, GTK_WIDGET (date))
+	    || !gtk_widget_has_focus (focus))
+		{
+			gtk_date_entry_finish_editing (date, FALSE);
+		}
+
+	return FALSE;
+}
+
+/*
+ * marks the allowed days of the calendar's month: the month's julian
+ * days are computed once and intersected with the owner's bounds, and
+ * the business days are one bitmask of the month; without bounds and
+ * rules no day is marked
+ */
+static void
+gtk_date_entry_mark_calendar (void)
+{
+	guint day, month, year;
+	guint32 first;
+	guint32 last;
+	guint32 lo;
+	guint32 hi;
+	guint32 allowed;
+	GDate gdate;
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (popup.owner);
+
+	gtk_calendar_clear_marks (GTK_CALENDAR (popup.calendar));
+	if (priv->min_julian == 0 && priv->max_julian == 0 && priv->rules == NULL)
+		{
+			return;
+		}
+
+	gtk_calendar_get_date (GTK_CALENDAR (popup.calendar), &year, &month, &day);
+
+	g_date_clear (&gdate, 1);
+	g_date_set_dmy (&gdate, 1, (GDateMonth)(month + 1), (GDateYear)year);
+	first = g_date_get_julian (&gdate);
+	last = first + g_date_get_days_in_month ((GDateMonth)(month + 1), (GDateYear)year) - 1;
+
+	lo = MAX (first, priv->min_julian);
+	hi = priv->max_julian != 0 ? MIN (last, priv->max_julian) : last;
+	if (lo > hi)
+		{
+			return;
+		}
+
+	/* the bits from lo to hi, as days of the month from 0 */
+	allowed = (guint32)((((guint64)1 << (hi - first + 1)) - 1) & ~(((guint64)1 << (lo - first)) - 1));
+	if (priv->rules != NULL)
+		{
+			allowed &= gtk_date_calendar_rules_get_business_days (priv->rules,
+			                                                      (GDateYear)year,
+			                                                      (GDateMonth)(month + 1));
+		}
+
+	for (day = 0; allowed != 0; day++, allowed >>= 1)
+		{
+			if (allowed & 1)
+				{
+					gtk_calendar_mark_day (GTK_CALENDAR (popup.calendar), day + 1);
+				}
+		}
+}
+
+/* marks the date's segments touched by the characters from @start_pos to
+ * @end_pos */
+static void
+gtk_date_entry_mark_segments (GtkDateEntry *date,
+                              gint start_pos,
+                              gint end_pos)
+{
+	guint i;
+	guint offset;
+	guint width;
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	for (i = 0; i < 3 && gtk_date_format_get_field (priv->compiled, i, &offset, &width) != 0; i++)
+		{
+			if (start_pos <= (gint)(offset + width) && end_pos >= (gint)offset)
+				{
+					priv->seg_dirty |= 1 << i;
+				}
+		}
+}
+
+/* reads the digits of @segment: it is complete if they are all there, and
+ * wrong if they are out of the field's range */
+static void
+gtk_date_entry_validate_segment (GtkDateEntry *date,
+                                 const gchar *text,
+                                 guint segment)
+{
+	const gchar *p;
+	gchar field;
+	guint offset;
+	guint width;
+	guint i;
+	gint value;
+	gint max;
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	priv->seg_complete &= ~(1 << segment);
+	priv->seg_error &= ~(1 << segment);
+
+	field = gtk_date_format_get_field (priv->compiled, segment, &offset, &width);
+	if (field == 0 || strlen (text) < offset + width)
+		{
+			return;
+		}
+
+	p = text + offset;
+	value = 0;
+	for (i = 0; i < width; i++)
+		{
+			if (p[i] < '0' || p[i] > '9')
+				{
+					return;
+				}
+			value = value * 10 + (p[i] - '0');
+		}
+
+	priv->seg_values[segment] = value;
+	priv->seg_complete |= 1 << segment;
+
+	max = field == 'd' ? 31 : field == 'm' ? 12 : 9999;
+	if (value < 1 || value > max)
+		{
+			priv->seg_error |= 1 << segment;
+		}
+}
+
+/*
+ * validates the edited segments, then checks the day of the month if all
+ * are right; it updates the value, the "complete" property and the error's
+ * style class
+ */
+static void
+gtk_date_entry_validate (GtkDateEntry *date)
+{
+	const gchar *text;
+	gint dmy[3];
+	guint i;
+	gboolean complete;
+	gboolean error;
+	GtkStyleContext *context;
+	GDate gdate;
+	guint32 julian;
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	text = gtk_entry_get_text (GTK_ENTRY (priv->day));
+	for (i = 0; i < 3; i++)
+		{
+			if (priv->seg_dirty & (1 << i))
+				{
+					gtk_date_entry_validate_segment (date, text, i);
+				}
+		}
+	priv->seg_dirty = 0;
+
+	complete = priv->seg_complete == 0x7;
+	error = priv->seg_error != 0;
+
+	priv->value.valid = FALSE;
+	priv->value.julian = 0;
+	if (complete && !error)
+		{
+			for (i = 0; i < 3; i++)
+				{
+					switch (gtk_date_format_get_field (priv->compiled, i, NULL, NULL))
+						{
+							case 'd': dmy[0] = priv->seg_values[i]; break;
+							case 'm': dmy[1] = priv->seg_values[i]; break;
+							default: dmy[2] = priv->seg_values[i]; break;
+						}
+				}
+
+			if (dmy[0] <= g_date_get_days_in_month (dmy[1], dmy[2]))
+				{
+					g_date_clear (&gdate, 1);
+					g_date_set_dmy (&gdate, dmy[0], dmy[1], dmy[2]);
+					julian = g_date_get_julian (&gdate);
+					if (gtk_date_entry_is_allowed (date, julian))
+						{
+							priv->value.julian = julian;
+							priv->value.valid = TRUE;
+						}
+					else
+						{
+							error = TRUE;
+						}
+				}
+			else
+				{
+					error = TRUE;
+				}
+		}
+
+	if (complete != priv->complete)
+		{
+			priv->complete = complete;
+			g_object_notify (G_OBJECT (date), "complete");
+		}
+
+	context = gtk_widget_get_style_context (priv->day);
+	if (error != gtk_style_context_has_class (context, GTK_STYLE_CLASS_ERROR))
+		{
+			if (error)
+				{
+					gtk_style_context_add_class (context, GTK_STYLE_CLASS_ERROR);
+				}
+			else
+				{
+					gtk_style_context_remove_class (context, GTK_STYLE_CLASS_ERROR);
+				}
+		}
+}
+
+/* sets the time part in the cache, and in the spins if they are built */
+static void
+gtk_date_entry_set_time_seconds (GtkDateEntry *date,
+                                 gint32 seconds)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->value.seconds == (guint)seconds)
+		{
+			return;
+		}
+
+	priv->value.seconds = seconds;
+	gtk_date_entry_sync_spins (date);
+
+	g_object_notify (G_OBJECT (date), "seconds");
+	g_object_notify (G_OBJECT (date), "unix-usec");
+
+	gtk_date_entry_emit_value_changed (date);
+}
+
+/* emits "value-changed" if the value isn't the one of the last emission,
+ * unless it is frozen */
+static void
+gtk_date_entry_emit_value_changed (GtkDateEntry *date)
+{
+	gint64 packed;
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->freeze_count > 0)
+		{
+			return;
+		}
+
+	packed = gtk_date_entry_get_packed (date);
+	if (packed != priv->packed)
+		{
+			priv->packed = packed;
+			g_signal_emit (date, signals[VALUE_CHANGED], 0, packed);
+		}
+}
+
+/* copies the cached time part into the spins */
+static void
+gtk_date_entry_sync_spins (GtkDateEntry *date)
+{
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (priv->spnHours == NULL)
+		{
+			return;
+		}
+
+	g_signal_handlers_block_by_func (priv->spnHours, spn_time_on_value_changed, date);
+	g_signal_handlers_block_by_func (priv->spnMinutes, spn_time_on_value_changed, date);
+	g_signal_handlers_block_by_func (priv->spnSeconds, spn_time_on_value_changed, date);
+
+	gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnHours),
+	                           (gdouble)(priv->value.seconds / 3600));
+	gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnMinutes),
+	                           (gdouble)((priv->value.seconds / 60) % 60));
+	gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->spnSeconds),
+	                           (gdouble)(priv->value.seconds % 60));
+
+	g_signal_handlers_unblock_by_func (priv->spnHours, spn_time_on_value_changed, date);
+	g_signal_handlers_unblock_by_func (priv->spnMinutes, spn_time_on_value_changed, date);
+	g_signal_handlers_unblock_by_func (priv->spnSeconds, spn_time_on_value_changed, date);
+}
+
+static void
+gtk_date_entry_build_time (GtkDateEntry *date)
+{
+	gboolean is_editable;
+
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	priv->spnHours = gtk_spin_button_new_with_range (0, 23, 1);
+	gtk_entry_set_width_chars (GTK_ENTRY (priv->spnHours), 2);
+	gtk_widget_set_no_show_all (priv->spnHours, TRUE);
+
+	priv->lblMinutes = gtk_label_new (priv->time_separator);
+	gtk_widget_set_no_show_all (priv->lblMinutes, TRUE);
+	priv->spnMinutes = gtk_spin_button_new_with_range (0, 59, 1);
+	gtk_entry_set_width_chars (GTK_ENTRY (priv->spnMinutes), 2);
+	gtk_widget_set_no_show_all (priv->spnMinutes, TRUE);
+
+	priv->lblSeconds = gtk_label_new (priv->time_separator);
+	gtk_widget_set_no_show_all (priv->lblSeconds, TRUE);
+	priv->spnSeconds = gtk_spin_button_new_with_range (0, 59, 1);
+	gtk_entry_set_width_chars (GTK_ENTRY (priv->spnSeconds), 2);
+	gtk_widget_set_no_show_all (priv->spnSeconds, TRUE);
+
+	gtk_spin_button_set_numeric (GTK_SPIN_BUTTON (priv->spnHours), TRUE);
+	gtk_spin_button_set_numeric (GTK_SPIN_BUTTON (priv->spnMinutes), TRUE);
+	gtk_spin_button_set_numeric (GTK_SPIN_BUTTON (priv->spnSeconds), TRUE);
+
+	gtk_spin_button_set_digits (GTK_SPIN_BUTTON (priv->spnHours), 0);
+	gtk_spin_button_set_digits (GTK_SPIN_BUTTON (priv->spnMinutes), 0);
+	gtk_spin_button_set_digits (GTK_SPIN_BUTTON (priv->spnSeconds), 0);
+
+	is_editable = gtk_editable_get_editable (GTK_EDITABLE (priv->day));
+	gtk_widget_set_sensitive (priv->spnHours, is_editable);
+	gtk_widget_set_sensitive (priv->spnMinutes, is_editable);
+	gtk_widget_set_sensitive (priv->spnSeconds, is_editable);
 
-	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+	gtk_date_entry_sync_spins (date);
+
+	g_signal_connect (G_OBJECT (priv->spnHours), "value-changed",
+	                  G_CALLBACK (spn_time_on_value_changed), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->spnMinutes), "value-changed",
+	                  G_CALLBACK (spn_time_on_value_changed), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->spnSeconds), "value-changed",
+	                  G_CALLBACK (spn_time_on_value_changed), (gpointer)date);
+
+	/* the time's parts end the cell's editing as the date's one */
+	g_signal_connect (G_OBJECT (priv->spnHours), "activate",
+	                  G_CALLBACK (part_on_activate), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->spnMinutes), "activate",
+	                  G_CALLBACK (part_on_activate), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->spnSeconds), "activate",
+	                  G_CALLBACK (part_on_activate), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->spnHours), "key-press-event",
+	                  G_CALLBACK (part_on_key_press_event), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->spnMinutes), "key-press-event",
+	                  G_CALLBACK (part_on_key_press_event), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->spnSeconds), "key-press-event",
+	                  G_CALLBACK (part_on_key_press_event), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->spnHours), "focus-out-event",
+	                  G_CALLBACK (part_on_focus_out_event), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->spnMinutes), "focus-out-event",
+	                  G_CALLBACK (part_on_focus_out_event), (gpointer)date);
+	g_signal_connect (G_OBJECT (priv->spnSeconds), "focus-out-event",
+	                  G_CALLBACK (part_on_focus_out_event), (gpointer)date);
 
-	return priv->time_is_visible;
+	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->spnHours, TRUE, TRUE, 0);
+	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->lblMinutes, FALSE, FALSE, 3);
+	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->spnMinutes, TRUE, TRUE, 0);
+	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->lblSeconds, FALSE, FALSE, 3);
+	gtk_box_pack_start (GTK_BOX (priv->hbox), priv->spnSeconds, TRUE, TRUE, 0);
 }
 
-/* PRIVATE */
+/* shows the time's widgets as the time_* flags say */
 static void
-gtk_date_entry_change_mask (GtkDateEntry *date)
+gtk_date_entry_show_time (GtkDateEntry *date)
 {
-	gchar *mask, *format[3];
-	gint i;
-
-	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
-
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
 
-	for (i = 0; i < 3; i++)
+	if (priv->spnHours == NULL)
 		{
-			if (priv->format[i] == 'd' || priv->format[i] == 'm')
-				{
-					format[i] = g_strdup ("00");
-				}
-			else if (priv->format[i] == 'Y')
-				{
-					format[i] = g_strdup ("0000");
-				}
+			return;
 		}
 
-	mask = g_strdup_printf ("%s%s%s%s%s",
-	                        format[0],
-	                        priv->separator,
-	                        format[1],
-	                        priv->separator,
-	                        format[2]);
-	gtk_masked_entry_set_mask (GTK_MASKED_ENTRY (priv->day), mask);
+	gtk_widget_set_visible (priv->spnHours, priv->time_is_visible);
+	gtk_widget_set_visible (priv->lblMinutes, priv->time_is_visible);
+	gtk_widget_set_visible (priv->spnMinutes, priv->time_is_visible);
+	gtk_widget_set_visible (priv->lblSeconds, priv->time_is_visible && priv->time_with_seconds);
+	gtk_widget_set_visible (priv->spnSeconds, priv->time_is_visible && priv->time_with_seconds);
 }
 
 /*
@@ -1366,9 +3255,32 @@ hide_popup (GtkWidget *date)
 
 	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE ((GtkDateEntry *)date);
 
-	gtk_widget_hide (priv->wCalendar);
-	gtk_grab_remove (priv->wCalendar);
+	if (popup.owner != (GtkDateEntry *)date)
+		{
+			return;
+		}
+
+	gtk_widget_hide (popup.window);
+	gtk_grab_remove (popup.window);
+	popup.owner = NULL;
 	gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->btnCalendar), FALSE);
+
+	/* the popup is kept for a while, in case it is opened again */
+	if (popup.timeout_id == 0)
+		{
+			popup.timeout_id = g_timeout_add_seconds (GTK_DATE_ENTRY_POPUP_TIMEOUT,
+			                                          popup_on_timeout,
+			                                          NULL);
+		}
+}
+
+static gboolean
+popup_on_timeout (gpointer user_data)
+{
+	popup.timeout_id = 0;
+	gtk_date_entry_destroy_popup ();
+
+	return FALSE;
 }
 
 static gboolean
@@ -1398,7 +3310,10 @@ static gint
 delete_popup (GtkWidget *widget,
               gpointer data)
 {
-	hide_popup ((GtkWidget *)data);
+	if (popup.owner != NULL)
+		{
+			hide_popup ((GtkWidget *)popup.owner);
+		}
 
 	return TRUE;
 }
@@ -1423,7 +3338,10 @@ key_press_popup (GtkWidget *widget,
 		}
 
 	g_signal_stop_emission_by_name (widget, "key_press_event");
-	hide_popup ((GtkWidget *)data);
+	if (popup.owner != NULL)
+		{
+			hide_popup ((GtkWidget *)popup.owner);
+		}
 
 	return TRUE;
 }
@@ -1434,7 +3352,6 @@ button_press_popup (GtkWidget *widget,
                     GdkEventButton *event,
                     gpointer user_data)
 {
-	GtkDateEntry *date = (GtkDateEntry *)user_data;
 	GtkWidget *child = gtk_get_event_widget ((GdkEvent *)event);
 
 	/* We don't ask for button press events on the grab widget, so
@@ -1451,7 +3368,10 @@ button_press_popup (GtkWidget *widget,
 		}
 	}
 
-	hide_popup (user_data);
+	if (popup.owner != NULL)
+		{
+			hide_popup ((GtkWidget *)popup.owner);
+		}
 
 	return TRUE;
 }
@@ -1470,17 +3390,46 @@ btnCalendar_on_toggled (GtkToggleButton *togglebutton,
 			gint x, y, bwidth, bheight;
 			GtkRequisition req;
 			GtkWidget *btn = priv->btnCalendar,
-			          *wCalendar = priv->wCalendar;
+			          *wCalendar;
+
+			GDate gdate;
+
+			if (popup.timeout_id != 0)
+				{
+					g_source_remove (popup.timeout_id);
+					popup.timeout_id = 0;
+				}
+			if (popup.window == NULL)
+				{
+					gtk_date_entry_build_popup ();
+				}
+			if (popup.owner != NULL && popup.owner != date)
+				{
+					hide_popup ((GtkWidget *)popup.owner);
+				}
+			wCalendar = popup.window;
+			gtk_window_set_screen (GTK_WINDOW (wCalendar), gtk_widget_get_screen (btn));
 
 			/* sets current date */
-			const GDate *gdate = gtk_date_entry_get_gdate (date);
-			if (gdate != NULL)
+			if (priv->value.valid)
+				{
+					g_date_clear (&gdate, 1);
+					g_date_set_julian (&gdate, priv->value.julian);
+					gtk_calendar_select_month (GTK_CALENDAR (popup.calendar),
+					                           (guint)g_date_get_month (&gdate) - 1,
+					                           (guint)g_date_get_year (&gdate));
+					gtk_calendar_select_day (GTK_CALENDAR (popup.calendar),
+					                         (guint)g_date_get_day (&gdate));
+				}
+			else
 				{
-					gtk_calendar_select_month (GTK_CALENDAR (priv->calendar),
-					                           (guint)g_date_get_month (gdate) - 1,
-					                           (guint)g_date_get_year (gdate));
-					gtk_calendar_select_day (GTK_CALENDAR (priv->calendar),
-					                         (guint)g_date_get_day (gdate));
+					/* the calendar is shared: not the previous owner's date */
+					GDateTime *now = g_date_time_new_now_local ();
+					gtk_calendar_select_month (GTK_CALENDAR (popup.calendar),
+					                           (guint)g_date_time_get_month (now) - 1,
+					                           (guint)g_date_time_get_year (now));
+					gtk_calendar_select_day (GTK_CALENDAR (popup.calendar), 0);
+					g_date_time_unref (now);
 				}
 
 			/* show calendar */
@@ -1502,7 +3451,11 @@ btnCalendar_on_toggled (GtkToggleButton *togglebutton,
 			gtk_grab_add (wCalendar);
 			gtk_window_move (GTK_WINDOW (wCalendar), x, y);
 			gtk_widget_show (wCalendar);
-			gtk_widget_grab_focus (priv->calendar);
+			/* the owner is set after the date, so the calendar's
+			 * day-selected doesn't write it back */
+			popup.owner = date;
+			gtk_date_entry_mark_calendar ();
+			gtk_widget_grab_focus (popup.calendar);
 			window = gtk_widget_get_window (wCalendar);
 			popup_grab_on_window (window, gtk_get_current_event_time ());
 		}
@@ -1513,19 +3466,174 @@ calendar_on_day_selected (GtkCalendar *calendar,
                           gpointer user_data)
 {
 	guint day, month, year;
+	gint32 julian;
+	GDate gdate;
+
+	if (popup.owner == NULL)
+		{
+			return;
+		}
 
 	gtk_calendar_get_date (calendar, &year, &month, &day);
-	gtk_date_entry_set_date_gdate ((GtkDateEntry *)user_data,
-	                               g_date_new_dmy ((GDateDay)day,
-	                                               (GDateMonth)(month + 1),
-	                                               (GDateYear)year));
+
+	g_date_clear (&gdate, 1);
+	g_date_set_dmy (&gdate, (GDateDay)day, (GDateMonth)(month + 1), (GDateYear)year);
+	julian = g_date_get_julian (&gdate);
+
+	/* the days out of the bounds and the closed ones aren't taken */
+	if (!gtk_date_entry_is_allowed (popup.owner, julian))
+		{
+			return;
+		}
+
+	gtk_date_entry_set_date_julian (popup.owner, julian);
 }
 
 static void
 calendar_on_day_selected_double_click (GtkCalendar *calendar,
                                        gpointer user_data)
 {
-	hide_popup ((GtkWidget *)user_data);
+	GtkDateEntry *date = popup.owner;
+
+	if (date != NULL)
+		{
+			hide_popup ((GtkWidget *)date);
+			gtk_date_entry_finish_editing (date, FALSE);
+		}
+}
+
+static void
+calendar_on_month_changed (GtkCalendar *calendar,
+                           gpointer user_data)
+{
+	if (popup.owner != NULL)
+		{
+			gtk_date_entry_mark_calendar ();
+		}
+}
+
+/* the edited segments are validated again in day_on_changed */
+static void
+day_on_insert_text (GtkEditable *editable,
+                    gchar *new_text,
+                    gint new_text_length,
+                    gpointer position,
+                    gpointer user_data)
+{
+	gint start_pos = *(gint *)position;
+
+	if (new_text_length < 0)
+		{
+			new_text_length = strlen (new_text);
+		}
+
+	gtk_date_entry_mark_segments ((GtkDateEntry *)user_data, start_pos, start_pos + new_text_length);
+}
+
+static void
+day_on_delete_text (GtkEditable *editable,
+                    gint start_pos,
+                    gint end_pos,
+                    gpointer user_data)
+{
+	gtk_date_entry_mark_segments ((GtkDateEntry *)user_data, start_pos, end_pos < 0 ? G_MAXINT : end_pos);
+}
+
+static void
+day_on_changed (GtkEditable *editable,
+                gpointer user_data)
+{
+	GtkDateEntry *date = (GtkDateEntry *)user_data;
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	GtkDateEntryValue old = priv->value;
+
+	priv->date_cleared = FALSE;
+	gtk_date_entry_validate (date);
+
+	if (priv->value.valid != old.valid
+	    || priv->value.julian != old.julian)
+		{
+			g_object_notify (G_OBJECT (date), "julian");
+			g_object_notify (G_OBJECT (date), "unix-usec");
+			if (priv->value.valid != old.valid)
+				{
+					g_object_notify (G_OBJECT (date), "valid");
+				}
+
+			gtk_date_entry_emit_value_changed (date);
+		}
+}
+
+static void
+rules_on_changed (GtkDateCalendarRules *rules,
+                  gpointer user_data)
+{
+	gtk_date_entry_revalidate ((GtkDateEntry *)user_data);
+}
+
+static void
+part_on_activate (GtkEntry *entry,
+                 gpointer user_data)
+{
+	gtk_date_entry_finish_editing ((GtkDateEntry *)user_data, FALSE);
+}
+
+static gboolean
+part_on_key_press_event (GtkWidget *widget,
+                         GdkEventKey *event,
+                         gpointer user_data)
+{
+	GtkDateEntry *date = (GtkDateEntry *)user_data;
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	if (!priv->editing || event->keyval != GDK_KEY_Escape)
+		{
+			return FALSE;
+		}
+
+	gtk_date_entry_finish_editing (date, TRUE);
+
+	return TRUE;
+}
+
+static gboolean
+part_on_focus_out_event (GtkWidget *widget,
+                         GdkEventFocus *event,
+                         gpointer user_data)
+{
+	GtkDateEntry *date = (GtkDateEntry *)user_data;
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	/* the focus may go to another part: it is known after this event */
+	if (priv->editing && priv->focus_check_id == 0)
+		{
+			priv->focus_check_id = g_idle_add (gtk_date_entry_check_focus, date);
+		}
+
+	return FALSE;
+}
+
+static void
+spn_time_on_value_changed (GtkSpinButton *spin_button,
+                           gpointer user_data)
+{
+	GtkDateEntry *date = (GtkDateEntry *)user_data;
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (date);
+
+	guint old = priv->value.seconds;
+
+	priv->value.seconds = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnHours)) * 3600
+	                      + gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnMinutes)) * 60
+	                      + gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->spnSeconds));
+
+	if (priv->value.seconds != old)
+		{
+			g_object_notify (G_OBJECT (date), "seconds");
+			g_object_notify (G_OBJECT (date), "unix-usec");
+
+			gtk_date_entry_emit_value_changed (date);
+		}
 }
 
 static void
@@ -1537,7 +3645,17 @@ gtk_date_entry_set_property (GObject *object, guint property_id, const GValue *v
 	switch (property_id)
 		{
 			case PROP_SEPARATOR:
-				gtk_date_entry_set_separator (date_entry, g_value_get_string (value));
+				if (g_value_get_string (value) != NULL)
+					{
+						gtk_date_entry_set_separator (date_entry, g_value_get_string (value));
+					}
+				else if (priv->constructed)
+					{
+						/* back to the locale's one */
+						GtkDateFormat *fmt = _gtk_date_entry_ref_locale_format ();
+						gtk_date_entry_set_separator (date_entry, gtk_date_format_get_separator (fmt));
+						gtk_date_format_unref (fmt);
+					}
 				break;
 
 			case PROP_TIME_SEPARATOR:
@@ -1545,7 +3663,17 @@ gtk_date_entry_set_property (GObject *object, guint property_id, const GValue *v
 				break;
 
 			case PROP_FORMAT:
-				gtk_date_entry_set_format (date_entry, g_value_get_string (value));
+				if (g_value_get_string (value) != NULL)
+					{
+						gtk_date_entry_set_format (date_entry, g_value_get_string (value));
+					}
+				else if (priv->constructed)
+					{
+						/* back to the locale's one */
+						GtkDateFormat *fmt = _gtk_date_entry_ref_locale_format ();
+						gtk_date_entry_set_format (date_entry, gtk_date_format_get_format (fmt));
+						gtk_date_format_unref (fmt);
+					}
 				break;
 
 			case PROP_EDITABLE_WITH_CALENDAR:
@@ -1565,8 +3693,52 @@ gtk_date_entry_set_property (GObject *object, guint property_id, const GValue *v
 				break;
 
 			case PROP_TIME_WITH_SECONDS:
+				if (priv->time_with_seconds == g_value_get_boolean (value))
+					{
+						GTK_DATE_ENTRY_COUNT (updates_skipped);
+						break;
+					}
+				GTK_DATE_ENTRY_COUNT (updates_applied);
 				priv->time_with_seconds = g_value_get_boolean (value);
-				gtk_date_entry_set_time_visible (date_entry, priv->time_is_visible);
+				gtk_date_entry_apply_time_visible (date_entry);
+				break;
+
+			case PROP_JULIAN:
+				gtk_date_entry_set_julian_seconds (date_entry, g_value_get_uint (value),
+				                                   gtk_date_entry_get_seconds (date_entry));
+				break;
+
+			case PROP_SECONDS:
+				gtk_date_entry_set_julian_seconds (date_entry, gtk_date_entry_get_julian (date_entry),
+				                                   g_value_get_int (value));
+				break;
+
+			case PROP_UNIX_USEC:
+				gtk_date_entry_set_unix_usec (date_entry, g_value_get_int64 (value));
+				break;
+
+			case PROP_TIMEZONE:
+				gtk_date_entry_set_timezone (date_entry, g_value_get_boxed (value));
+				break;
+
+			case PROP_UTC:
+				gtk_date_entry_set_utc (date_entry, g_value_get_boolean (value));
+				break;
+
+			case PROP_MIN_DATE:
+				gtk_date_entry_set_min_date (date_entry, g_value_get_uint (value));
+				break;
+
+			case PROP_MAX_DATE:
+				gtk_date_entry_set_max_date (date_entry, g_value_get_uint (value));
+				break;
+
+			case PROP_CALENDAR_RULES:
+				gtk_date_entry_set_calendar_rules (date_entry, g_value_get_object (value));
+				break;
+
+			case PROP_EDITING_CANCELED:
+				GTK_DATE_ENTRY_GET_PRIVATE (date_entry)->editing_canceled = g_value_get_boolean (value);
 				break;
 
 			default:
@@ -1615,6 +3787,50 @@ gtk_date_entry_get_property (GObject *object, guint property_id, GValue *value,
 				g_value_set_boolean (value, priv->time_with_seconds);
 				break;
 
+			case PROP_JULIAN:
+				g_value_set_uint (value, gtk_date_entry_get_julian (date_entry));
+				break;
+
+			case PROP_SECONDS:
+				g_value_set_int (value, gtk_date_entry_get_seconds (date_entry));
+				break;
+
+			case PROP_UNIX_USEC:
+				g_value_set_int64 (value, gtk_date_entry_get_unix_usec (date_entry));
+				break;
+
+			case PROP_TIMEZONE:
+				g_value_set_boxed (value, gtk_date_entry_get_timezone (date_entry));
+				break;
+
+			case PROP_UTC:
+				g_value_set_boolean (value, gtk_date_entry_is_utc (date_entry));
+				break;
+
+			case PROP_VALID:
+				g_value_set_boolean (value, gtk_date_entry_is_valid (date_entry));
+				break;
+
+			case PROP_COMPLETE:
+				g_value_set_boolean (value, gtk_date_entry_is_complete (date_entry));
+				break;
+
+			case PROP_MIN_DATE:
+				g_value_set_uint (value, gtk_date_entry_get_min_date (date_entry));
+				break;
+
+			case PROP_MAX_DATE:
+				g_value_set_uint (value, gtk_date_entry_get_max_date (date_entry));
+				break;
+
+			case PROP_CALENDAR_RULES:
+				g_value_set_object (value, gtk_date_entry_get_calendar_rules (date_entry));
+				break;
+
+			case PROP_EDITING_CANCELED:
+				g_value_set_boolean (value, GTK_DATE_ENTRY_GET_PRIVATE (date_entry)->editing_canceled);
+				break;
+
 			default:
 				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
 				break;
@@ -1626,8 +3842,7 @@ gtk_date_entry_get_preferred_height (GtkWidget *widget,
                                      gint *minimum_height,
                                      gint *natural_height)
 {
-	GtkDateEntry *date_entry;
-	GtkBin *bin;
+	GtkWidget *child;
 	GtkRequisition child_requisition;
 	GtkRequisition child_requisition_natural;
 
@@ -1637,22 +3852,20 @@ gtk_date_entry_get_preferred_height (GtkWidget *widget,
 	g_return_if_fail (minimum_height != NULL);
 	g_return_if_fail (natural_height != NULL);
 
-	date_entry = GTK_DATE_ENTRY (widget);
-	bin = GTK_BIN (date_entry);
+	child_requisition.width = 0;
+	child_requisition.height = 0;
+	child_requisition_natural = child_requisition;
 
-	minimum_height = 0;
-	natural_height = 0;
-
-	if (gtk_bin_get_child (bin) && gtk_widget_get_visible (gtk_bin_get_child (bin)))
+	/* gtk caches the child's request until it queues a resize */
+	child = gtk_bin_get_child (GTK_BIN (widget));
+	if (child != NULL && gtk_widget_get_visible (child))
 		{
-			gtk_widget_get_preferred_size (gtk_bin_get_child (bin), &child_requisition, &child_requisition_natural);
-			minimum_height += child_requisition.height;
-			natural_height += child_requisition_natural.height;
+			gtk_widget_get_preferred_size (child, &child_requisition, &child_requisition_natural);
 		}
 
 	border_width = gtk_container_get_border_width (GTK_CONTAINER (widget));
-	minimum_height += (border_width * 2);
-	natural_height += (border_width * 2);
+	*minimum_height = child_requisition.height + border_width * 2;
+	*natural_height = child_requisition_natural.height + border_width * 2;
 }
 
 static void
@@ -1660,8 +3873,7 @@ gtk_date_entry_get_preferred_width (GtkWidget *widget,
                                     gint *minimum_width,
                                     gint *natural_width)
 {
-	GtkDateEntry *date_entry;
-	GtkBin *bin;
+	GtkWidget *child;
 	GtkRequisition child_requisition;
 	GtkRequisition child_requisition_natural;
 
@@ -1671,22 +3883,20 @@ gtk_date_entry_get_preferred_width (GtkWidget *widget,
 	g_return_if_fail (minimum_width != NULL);
 	g_return_if_fail (natural_width != NULL);
 
-	date_entry = GTK_DATE_ENTRY (widget);
-	bin = GTK_BIN (date_entry);
-
-	minimum_width = 0;
-	natural_width = 0;
+	child_requisition.width = 0;
+	child_requisition.height = 0;
+	child_requisition_natural = child_requisition;
 
-	if (gtk_bin_get_child (bin) && gtk_widget_get_visible (gtk_bin_get_child (bin)))
+	/* gtk caches the child's request until it queues a resize */
+	child = gtk_bin_get_child (GTK_BIN (widget));
+	if (child != NULL && gtk_widget_get_visible (child))
 		{
-			gtk_widget_get_preferred_size (gtk_bin_get_child (bin), &child_requisition, &child_requisition_natural);
-			minimum_width += child_requisition.width;
-			natural_width += child_requisition_natural.width;
+			gtk_widget_get_preferred_size (child, &child_requisition, &child_requisition_natural);
 		}
 
 	border_width = gtk_container_get_border_width (GTK_CONTAINER (widget));
-	minimum_width += (border_width * 2);
-	natural_width += (border_width * 2);
+	*minimum_width = child_requisition.width + border_width * 2;
+	*natural_width = child_requisition_natural.width + border_width * 2;
 }
 
 static void
@@ -1726,67 +3936,35 @@ gtk_date_entry_size_allocate (GtkWidget *widget,
 		}
 }
 
-static gchar
-*gtk_date_entry_get_separator_from_locale ()
+static void
+gtk_date_entry_parent_set (GtkWidget *widget,
+                           GtkWidget *previous_parent)
 {
-	gchar *fmt;
+	GtkDateEntryPrivate *priv = GTK_DATE_ENTRY_GET_PRIVATE (widget);
 
-	gchar *lfmt;
-	guint l;
-	guint i;
-
-	fmt = NULL;
-
-#ifdef G_OS_WIN32
-
-	gchar lpLCData[30];
-
-	if (GetLocaleInfo (LOCALE_USER_DEFAULT, LOCALE_SSHORTDATE, (LPTSTR)&lpLCData, 30) == 0)
+	if (GTK_WIDGET_CLASS (parent_class)->parent_set != NULL)
 		{
-			g_warning ("Unable to get locale information");
-			return NULL;
+			GTK_WIDGET_CLASS (parent_class)->parent_set (widget, previous_parent);
 		}
-	lfmt = g_strdup ((const gchar *)&lpLCData);
-
-#else
-
-	lfmt = nl_langinfo (D_FMT);
-
-#endif
 
-	l = strlen (lfmt);
-	for (i = 0; i < l; i++)
+	if (priv->time_is_visible
+	    && priv->spnHours == NULL
+	    && gtk_widget_get_parent (widget) != NULL)
 		{
-			switch (lfmt[i])
-				{
-					case 'd':
-					case 'm':
-					case 'y':
-					case 'Y':
-					case '%':
-						break;
-
-					default:
-						fmt = g_strdup_printf ("%c", lfmt[i]);
-						i = l;
-						break;
-				}
+			gtk_date_entry_build_time (GTK_DATE_ENTRY (widget));
+			gtk_date_entry_show_time (GTK_DATE_ENTRY (widget));
 		}
-
-	return fmt;
 }
 
-static gchar
-*gtk_date_entry_get_format_from_locale ()
+/* reads the date's format and separator from the locale */
+static void
+gtk_date_entry_read_locale (gchar *format,
+                            gchar *separator)
 {
-	gchar *fmt;
-
-	gchar *lfmt;
+	const gchar *lfmt;
 	guint l;
 	guint i;
 
-	fmt = NULL;
-
 #ifdef G_OS_WIN32
 
 	gchar lpLCData[30];
@@ -1794,9 +3972,9 @@ static gchar
 	if (GetLocaleInfo (LOCALE_USER_DEFAULT, LOCALE_SSHORTDATE, (LPTSTR)&lpLCData, 30) == 0)
 		{
 			g_warning ("Unable to get locale information");
-			return NULL;
+			lpLCData[0] = '\0';
 		}
-	lfmt = g_strdup ((const gchar *)&lpLCData);
+	lfmt = (const gchar *)&lpLCData;
 
 #else
 
@@ -1804,29 +3982,81 @@ static gchar
 
 #endif
 
-	l = strlen (lfmt);
-	for (i = 0; i < l; i++)
+	/* every field once, in the order they appear; the separator is the
+	 * first char that isn't part of a field */
+	l = 0;
+	separator[0] = '\0';
+	for (i = 0; lfmt[i] != '\0'; i++)
 		{
+			gchar field;
+
 			switch (lfmt[i])
 				{
 					case 'd':
 					case 'D':
-						fmt = g_strconcat (fmt == NULL ? "" : fmt, fmt != NULL && strchr (fmt, 'd') != 0 ? "" : "d", NULL);
+						field = 'd';
 						break;
 
 					case 'm':
 					case 'M':
-						fmt = g_strconcat (fmt == NULL ? "" : fmt, fmt != NULL && strchr (fmt, 'm') != 0 ? "" : "m", NULL);
+						field = 'm';
 						break;
 
 					case 'y':
 					case 'Y':
-						fmt = g_strconcat (fmt == NULL ? "" : fmt, fmt != NULL && strchr (fmt, 'Y') != 0 ? "" : "Y", NULL);
+						field = 'Y';
+						break;
+
+					case '%':
+						field = '\0';
+						break;
+
+					default:
+						if (separator[0] == '\0')
+							{
+								separator[0] = lfmt[i];
+								separator[1] = '\0';
+							}
+						field = '\0';
 						break;
 				}
+
+			if (field != '\0' && l < 3 && memchr (format, field, l) == NULL)
+				{
+					format[l++] = field;
+				}
+		}
+	format[l] = '\0';
+
+	if (l != 3)
+		{
+			strcpy (format, "dmY");
+		}
+}
+
+/* the locale's format is read once and shared by all the entries, until
+ * gtk_date_entry_locale_changed () */
+GtkDateFormat
+*_gtk_date_entry_ref_locale_format (void)
+{
+	gchar format[4];
+	gchar separator[2];
+	GtkDateFormat *ret;
+
+	G_LOCK (locale_format);
+
+	if (locale_format == NULL)
+		{
+			gtk_date_entry_read_locale (format, separator);
+			locale_format = gtk_date_format_new (format,
+			                                     separator[0] != '\0' ? separator : NULL,
+			                                     ":");
 		}
+	ret = gtk_date_format_ref (locale_format);
+
+	G_UNLOCK (locale_format);
 
-	return fmt;
+	return ret;
 }
 
 static const gchar
@@ -1845,5 +4075,12 @@ static void
 gtk_date_entry_set_value (GdaExQueryEditorIWidget *iwidget,
                             const gchar *value)
 {
-	gtk_date_entry_set_date_strf (GTK_DATE_ENTRY (iwidget), value == NULL ?  g_date_time_format (g_date_time_new_now_local (), "%Y-%m-%d %H.%M.%S") : value, "YmdHMS");
+	if (value == NULL)
+		{
+			gtk_date_entry_set_unix_usec (GTK_DATE_ENTRY (iwidget), g_get_real_time ());
+		}
+	else
+		{
+			gtk_date_entry_set_date_strf (GTK_DATE_ENTRY (iwidget), value, "YmdHMS");
+		}
 }
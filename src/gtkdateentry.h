@@ -27,6 +27,9 @@
 #include <gdk/gdk.h>
 #include <gtk/gtk.h>
 
+#include "gtkdatecalendarrules.h"
+#include "gtkdateformat.h"
+
 G_BEGIN_DECLS
 
 
@@ -53,12 +56,25 @@ struct _GtkDateEntryClass
 };
 
 
+/* the value of the "value-changed" signal: the julian day and the seconds
+ * of the day in one integer; 0 if the date isn't valid */
+#define GTK_DATE_ENTRY_PACK(julian, seconds) (((gint64)(julian) << 17) | (gint64)(seconds))
+#define GTK_DATE_ENTRY_PACKED_JULIAN(packed) ((guint32)((packed) >> 17))
+#define GTK_DATE_ENTRY_PACKED_SECONDS(packed) ((gint32)((packed) & 0x1ffff))
+
+
 GType gtk_date_entry_get_type (void) G_GNUC_CONST;
 
 GtkWidget *gtk_date_entry_new (const gchar *format,
                                const gchar *separator,
                                gboolean calendar_button_is_visible);
 
+void gtk_date_entry_locale_changed (void);
+void gtk_date_entry_time_zone_changed (void);
+
+void gtk_date_entry_get_update_counters (guint *applied,
+                                         guint *skipped);
+
 gboolean gtk_date_entry_set_separator (GtkDateEntry *date,
                                    const gchar *separator);
 gboolean gtk_date_entry_set_time_separator (GtkDateEntry *date,
@@ -73,6 +89,26 @@ const gchar *gtk_date_entry_get_strf (GtkDateEntry *date,
                                       const gchar *time_separator);
 const gchar *gtk_date_entry_get_sql (GtkDateEntry *date);
 
+gsize gtk_date_entry_get_text_into (GtkDateEntry *date,
+                                    gchar *buf,
+                                    gsize len);
+gsize gtk_date_entry_format_into (GtkDateEntry *date,
+                                  const gchar *format,
+                                  const gchar *separator,
+                                  const gchar *time_separator,
+                                  gchar *buf,
+                                  gsize len);
+gsize gtk_date_entry_get_sql_into (GtkDateEntry *date,
+                                   gchar *buf,
+                                   gsize len);
+
+gchar *gtk_date_entry_dup_text (GtkDateEntry *date);
+gchar *gtk_date_entry_dup_strf (GtkDateEntry *date,
+                                const gchar *format,
+                                const gchar *separator,
+                                const gchar *time_separator);
+gchar *gtk_date_entry_dup_sql (GtkDateEntry *date);
+
 struct tm *gtk_date_entry_get_tm (GtkDateEntry *date);
 GDate *gtk_date_entry_get_gdate (GtkDateEntry *date);
 GDateTime *gtk_date_entry_get_gdatetime (GtkDateEntry *date);
@@ -80,6 +116,8 @@ GDateTime *gtk_date_entry_get_gdatetime (GtkDateEntry *date);
 gboolean gtk_date_entry_set_date_strf (GtkDateEntry *date,
                                        const gchar *str,
                                        const gchar *format);
+gboolean gtk_date_entry_set_sql (GtkDateEntry *date,
+                                 const gchar *str);
 
 void gtk_date_entry_set_date_tm (GtkDateEntry *date,
                                  const struct tm tmdate);
@@ -89,6 +127,41 @@ void gtk_date_entry_set_date_gdatetime (GtkDateEntry *date,
                                         const GDateTime *gdatetime);
 
 gboolean gtk_date_entry_is_valid (GtkDateEntry *date);
+gboolean gtk_date_entry_is_complete (GtkDateEntry *date);
+
+guint32 gtk_date_entry_get_julian (GtkDateEntry *date);
+gint32 gtk_date_entry_get_seconds (GtkDateEntry *date);
+void gtk_date_entry_set_julian_seconds (GtkDateEntry *date,
+                                        guint32 julian,
+                                        gint32 seconds);
+
+gint64 gtk_date_entry_get_packed (GtkDateEntry *date);
+
+void gtk_date_entry_freeze_value_changed (GtkDateEntry *date);
+void gtk_date_entry_thaw_value_changed (GtkDateEntry *date);
+
+gint64 gtk_date_entry_get_unix_usec (GtkDateEntry *date);
+void gtk_date_entry_set_unix_usec (GtkDateEntry *date,
+                                   gint64 usec);
+
+void gtk_date_entry_set_timezone (GtkDateEntry *date,
+                                  GTimeZone *tz);
+GTimeZone *gtk_date_entry_get_timezone (GtkDateEntry *date);
+void gtk_date_entry_set_utc (GtkDateEntry *date,
+                             gboolean utc);
+gboolean gtk_date_entry_is_utc (GtkDateEntry *date);
+
+void gtk_date_entry_set_min_date (GtkDateEntry *date,
+                                  guint32 julian);
+guint32 gtk_date_entry_get_min_date (GtkDateEntry *date);
+void gtk_date_entry_set_max_date (GtkDateEntry *date,
+                                  guint32 julian);
+guint32 gtk_date_entry_get_max_date (GtkDateEntry *date);
+
+void gtk_date_entry_set_calendar_rules (GtkDateEntry *date,
+                                        GtkDateCalendarRules *rules);
+GtkDateCalendarRules *gtk_date_entry_get_calendar_rules (GtkDateEntry *date);
+gboolean gtk_date_entry_next_business_day (GtkDateEntry *date);
 
 void gtk_date_entry_set_editable (GtkDateEntry *date,
                                   gboolean is_editable);
@@ -0,0 +1,365 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+	#include <config.h>
+#endif
+
+#include <string.h>
+
+#include "gtkdateentrypool.h"
+#include "gtkdateentryprivate.h"
+
+static void gtk_date_entry_pool_class_init (GtkDateEntryPoolClass *klass);
+static void gtk_date_entry_pool_init (GtkDateEntryPool *pool);
+static void gtk_date_entry_pool_finalize (GObject *object);
+
+static void gtk_date_entry_pool_disconnect (GtkDateEntry *date,
+                                            GType type);
+static void gtk_date_entry_pool_reset (GtkDateEntry *date);
+
+static GObjectClass *parent_class = NULL;
+
+#define GTK_DATE_ENTRY_POOL_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GTK_TYPE_DATE_ENTRY_POOL, GtkDateEntryPoolPrivate))
+
+typedef struct _GtkDateEntryPoolPrivate GtkDateEntryPoolPrivate;
+struct _GtkDateEntryPoolPrivate
+	{
+		/* the released entries, with a reference */
+		GQueue entries;
+		guint max_size;
+
+		guint hits;
+		guint misses;
+		guint high_water;
+	};
+
+G_DEFINE_TYPE (GtkDateEntryPool, gtk_date_entry_pool, G_TYPE_OBJECT)
+
+static void
+gtk_date_entry_pool_class_init (GtkDateEntryPoolClass *klass)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	g_type_class_add_private (object_class, sizeof (GtkDateEntryPoolPrivate));
+
+	parent_class = g_type_class_peek_parent (klass);
+
+	object_class->finalize = gtk_date_entry_pool_finalize;
+}
+
+static void
+gtk_date_entry_pool_init (GtkDateEntryPool *pool)
+{
+	GtkDateEntryPoolPrivate *priv = GTK_DATE_ENTRY_POOL_GET_PRIVATE (pool);
+
+	g_queue_init (&priv->entries);
+}
+
+static void
+gtk_date_entry_pool_finalize (GObject *object)
+{
+	GtkWidget *date;
+
+	GtkDateEntryPoolPrivate *priv = GTK_DATE_ENTRY_POOL_GET_PRIVATE (object);
+
+	while ((date = g_queue_pop_head (&priv->entries)) != NULL)
+		{
+			gtk_widget_destroy (date);
+			g_object_unref (date);
+		}
+
+	G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+/**
+ * gtk_date_entry_pool_new:
+ * @max_size: the maximum number of released entries kept by the pool.
+ *
+ * Creates a pool of #GtkDateEntry for forms that build and destroy many
+ * entries: the released ones are reset and handed out again, instead of
+ * building new ones.
+ *
+ * Returns: the newly created #GtkDateEntryPool.
+ */
+GtkDateEntryPool
+*gtk_date_entry_pool_new (guint max_size)
+{
+	GtkDateEntryPool *pool;
+
+	pool = GTK_DATE_ENTRY_POOL (g_object_new (gtk_date_entry_pool_get_type (), NULL));
+
+	GTK_DATE_ENTRY_POOL_GET_PRIVATE (pool)->max_size = max_size;
+
+	return pool;
+}
+
+/**
+ * gtk_date_entry_pool_acquire:
+ * @pool: a #GtkDateEntryPool.
+ *
+ * Returns: (transfer floating): a #GtkDateEntry built with
+ * gtk_date_entry_new (NULL, NULL, TRUE), or one taken from @pool and reset
+ * as described in gtk_date_entry_pool_release().
+ */
+GtkWidget
+*gtk_date_entry_pool_acquire (GtkDateEntryPool *pool)
+{
+	GtkWidget *date;
+
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY_POOL (pool), NULL);
+
+	GtkDateEntryPoolPrivate *priv = GTK_DATE_ENTRY_POOL_GET_PRIVATE (pool);
+
+	date = g_queue_pop_head (&priv->entries);
+	if (date != NULL)
+		{
+			priv->hits++;
+
+			/* the pool's reference goes to the caller, as a new widget's one */
+			g_object_force_floating (G_OBJECT (date));
+		}
+	else
+		{
+			priv->misses++;
+
+			date = gtk_date_entry_new (NULL, NULL, TRUE);
+		}
+
+	return date;
+}
+
+/**
+ * gtk_date_entry_pool_release:
+ * @pool: a #GtkDateEntryPool.
+ * @date: a #GtkDateEntry taken from @pool.
+ *
+ * Gives @date back to @pool: it is removed from its container, its popup and
+ * its cell's editing are ended, its value is cleared and its properties are
+ * set to the default values.
+ *
+ * The handlers of #GtkDateEntry's and #GtkCellEditable's signals, and of the
+ * notifications of #GtkDateEntry's properties, are disconnected, the blocked
+ * ones too; the handlers of #GtkWidget's signals and of the plain "notify"
+ * are shared with GTK+ and must be disconnected by the caller.
+ *
+ * Of the #GtkWidget's state, the size request, the margins, the alignment,
+ * the expansion, the name, the opacity, the tooltip, the sensitivity and
+ * the style classes are reset.
+ *
+ * If @pool is full, @date is destroyed.
+ */
+void
+gtk_date_entry_pool_release (GtkDateEntryPool *pool,
+                             GtkDateEntry *date)
+{
+	GtkWidget *parent;
+
+	g_return_if_fail (GTK_IS_DATE_ENTRY_POOL (pool));
+	g_return_if_fail (GTK_IS_DATE_ENTRY (date));
+
+	GtkDateEntryPoolPrivate *priv = GTK_DATE_ENTRY_POOL_GET_PRIVATE (pool);
+
+	/* the pool's reference; a floating one is taken over */
+	g_object_ref_sink (date);
+
+	parent = gtk_widget_get_parent (GTK_WIDGET (date));
+	if (parent != NULL)
+		{
+			gtk_container_remove (GTK_CONTAINER (parent), GTK_WIDGET (date));
+		}
+
+	if (g_queue_get_length (&priv->entries) >= priv->max_size)
+		{
+			gtk_widget_destroy (GTK_WIDGET (date));
+			g_object_unref (date);
+			return;
+		}
+
+	gtk_date_entry_pool_reset (date);
+
+	g_queue_push_head (&priv->entries, date);
+	if (g_queue_get_length (&priv->entries) > priv->high_water)
+		{
+			priv->high_water = g_queue_get_length (&priv->entries);
+		}
+}
+
+/**
+ * gtk_date_entry_pool_get_size:
+ * @pool: a #GtkDateEntryPool.
+ *
+ * Returns: the number of entries kept by @pool.
+ */
+guint
+gtk_date_entry_pool_get_size (GtkDateEntryPool *pool)
+{
+	g_return_val_if_fail (GTK_IS_DATE_ENTRY_POOL (pool), 0);
+
+	GtkDateEntryPoolPrivate *priv = GTK_DATE_ENTRY_POOL_GET_PRIVATE (pool);
+
+	return g_queue_get_length (&priv->entries);
+}
+
+/**
+ * gtk_date_entry_pool_get_stats:
+ * @pool: a #GtkDateEntryPool.
+ * @hits: (out) (allow-none): the entries handed out from @pool.
+ * @misses: (out) (allow-none): the entries built because @pool was empty.
+ * @high_water: (out) (allow-none): the maximum number of entries kept by
+ * @pool at the same time.
+ *
+ * Gets the statistics to size @pool.
+ */
+void
+gtk_date_entry_pool_get_stats (GtkDateEntryPool *pool,
+                               guint *hits,
+                               guint *misses,
+                               guint *high_water)
+{
+	g_return_if_fail (GTK_IS_DATE_ENTRY_POOL (pool));
+
+	GtkDateEntryPoolPrivate *priv = GTK_DATE_ENTRY_POOL_GET_PRIVATE (pool);
+
+	if (hits != NULL)
+		{
+			*hits = priv->hits;
+		}
+	if (misses != NULL)
+		{
+			*misses = priv->misses;
+		}
+	if (high_water != NULL)
+		{
+			*high_water = priv->high_water;
+		}
+}
+
+/* PRIVATE */
+/* disconnects all the handlers of @type's own signals, and the ones of the
+ * notifications of @type's own properties */
+static void
+gtk_date_entry_pool_disconnect (GtkDateEntry *date,
+                                GType type)
+{
+	guint *ids;
+	guint n_ids;
+	GParamSpec **pspecs;
+	guint n_pspecs;
+	guint notify_id;
+	guint i;
+
+	ids = g_signal_list_ids (type, &n_ids);
+	for (i = 0; i < n_ids; i++)
+		{
+			g_signal_handlers_disconnect_matched (date, G_SIGNAL_MATCH_ID, ids[i], 0, NULL, NULL, NULL);
+		}
+	g_free (ids);
+
+	if (!G_TYPE_IS_CLASSED (type))
+		{
+			return;
+		}
+
+	notify_id = g_signal_lookup ("notify", G_TYPE_OBJECT);
+	pspecs = g_object_class_list_properties (G_OBJECT_GET_CLASS (date), &n_pspecs);
+	for (i = 0; i < n_pspecs; i++)
+		{
+			if (pspecs[i]->owner_type == type)
+				{
+					g_signal_handlers_disconnect_matched (date, G_SIGNAL_MATCH_ID | G_SIGNAL_MATCH_DETAIL,
+					                                      notify_id, g_param_spec_get_name_quark (pspecs[i]),
+					                                      NULL, NULL, NULL);
+				}
+		}
+	g_free (pspecs);
+}
+
+static void
+gtk_date_entry_pool_reset (GtkDateEntry *date)
+{
+	GtkStyleContext *context;
+	GList *classes;
+	GList *l;
+	GParamSpec **pspecs;
+	guint n_pspecs;
+	GValue value = G_VALUE_INIT;
+	guint i;
+
+	/* the entry doesn't connect to its own signals: these are the user's */
+	gtk_date_entry_pool_disconnect (date, GTK_TYPE_DATE_ENTRY);
+	gtk_date_entry_pool_disconnect (date, GTK_TYPE_CELL_EDITABLE);
+
+	_gtk_date_entry_stop_editing (date);
+
+	g_object_freeze_notify (G_OBJECT (date));
+
+	gtk_date_entry_set_julian_seconds (date, 0, 0);
+	gtk_date_entry_set_editable (date, TRUE);
+
+	/* the entry's own properties, except the value ones */
+	pspecs = g_object_class_list_properties (G_OBJECT_GET_CLASS (date), &n_pspecs);
+	for (i = 0; i < n_pspecs; i++)
+		{
+			if (pspecs[i]->owner_type != GTK_TYPE_DATE_ENTRY
+			    || (pspecs[i]->flags & G_PARAM_WRITABLE) == 0
+			    || (pspecs[i]->flags & G_PARAM_CONSTRUCT_ONLY) != 0
+			    || strcmp (pspecs[i]->name, "julian") == 0
+			    || strcmp (pspecs[i]->name, "seconds") == 0
+			    || strcmp (pspecs[i]->name, "unix-usec") == 0)
+				{
+					continue;
+				}
+
+			g_value_init (&value, G_PARAM_SPEC_VALUE_TYPE (pspecs[i]));
+			g_param_value_set_default (pspecs[i], &value);
+			g_object_set_property (G_OBJECT (date), pspecs[i]->name, &value);
+			g_value_unset (&value);
+		}
+	g_free (pspecs);
+
+	gtk_widget_set_sensitive (GTK_WIDGET (date), TRUE);
+	gtk_widget_set_tooltip_text (GTK_WIDGET (date), NULL);
+	gtk_widget_set_size_request (GTK_WIDGET (date), -1, -1);
+	gtk_widget_set_name (GTK_WIDGET (date), NULL);
+	gtk_widget_set_halign (GTK_WIDGET (date), GTK_ALIGN_FILL);
+	gtk_widget_set_valign (GTK_WIDGET (date), GTK_ALIGN_FILL);
+	gtk_widget_set_opacity (GTK_WIDGET (date), 1.0);
+	g_object_set (G_OBJECT (date),
+	              "margin", 0,
+	              "hexpand-set", FALSE,
+	              "vexpand-set", FALSE,
+	              "no-show-all", FALSE,
+	              NULL);
+
+	/* a new entry has no style class of its own */
+	context = gtk_widget_get_style_context (GTK_WIDGET (date));
+	classes = gtk_style_context_list_classes (context);
+	for (l = classes; l != NULL; l = l->next)
+		{
+			gtk_style_context_remove_class (context, (const gchar *)l->data);
+		}
+	g_list_free (classes);
+
+	gtk_widget_hide (GTK_WIDGET (date));
+
+	g_object_thaw_notify (G_OBJECT (date));
+}
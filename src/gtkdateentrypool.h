@@ -0,0 +1,70 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __GTK_DATE_ENTRY_POOL_H__
+#define __GTK_DATE_ENTRY_POOL_H__
+
+#include "gtkdateentry.h"
+
+G_BEGIN_DECLS
+
+
+#define GTK_TYPE_DATE_ENTRY_POOL           (gtk_date_entry_pool_get_type ())
+#define GTK_DATE_ENTRY_POOL(obj)           (G_TYPE_CHECK_INSTANCE_CAST ((obj), GTK_TYPE_DATE_ENTRY_POOL, GtkDateEntryPool))
+#define GTK_DATE_ENTRY_POOL_CLASS(klass)   (G_TYPE_CHECK_CLASS_CAST ((klass), GTK_TYPE_DATE_ENTRY_POOL, GtkDateEntryPoolClass))
+#define GTK_IS_DATE_ENTRY_POOL(obj)        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GTK_TYPE_DATE_ENTRY_POOL))
+#define GTK_IS_DATE_ENTRY_POOL_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), GTK_TYPE_DATE_ENTRY_POOL))
+#define GTK_DATE_ENTRY_POOL_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), GTK_TYPE_DATE_ENTRY_POOL, GtkDateEntryPoolClass))
+
+
+typedef struct _GtkDateEntryPool GtkDateEntryPool;
+typedef struct _GtkDateEntryPoolClass GtkDateEntryPoolClass;
+
+
+struct _GtkDateEntryPool
+{
+	GObject parent;
+};
+
+struct _GtkDateEntryPoolClass
+{
+	GObjectClass parent_class;
+};
+
+
+GType gtk_date_entry_pool_get_type (void) G_GNUC_CONST;
+
+GtkDateEntryPool *gtk_date_entry_pool_new (guint max_size);
+
+GtkWidget *gtk_date_entry_pool_acquire (GtkDateEntryPool *pool);
+void gtk_date_entry_pool_release (GtkDateEntryPool *pool,
+                                  GtkDateEntry *date);
+
+guint gtk_date_entry_pool_get_size (GtkDateEntryPool *pool);
+void gtk_date_entry_pool_get_stats (GtkDateEntryPool *pool,
+                                    guint *hits,
+                                    guint *misses,
+                                    guint *high_water);
+
+
+G_END_DECLS
+
+#endif /* __GTK_DATE_ENTRY_POOL_H__ */
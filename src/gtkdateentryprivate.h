@@ -0,0 +1,96 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __GTK_DATE_ENTRY_PRIVATE_H__
+#define __GTK_DATE_ENTRY_PRIVATE_H__
+
+/* shared by the library's widgets; not installed */
+
+#include "gtkdateentry.h"
+#include "gtkdateformat.h"
+
+G_BEGIN_DECLS
+
+
+/* GDate's julian day of 1970-01-01 */
+#define GTK_DATE_ENTRY_JULIAN_1970 719163
+
+/* the canonical value of the widget, kept up to date by the "changed"
+ * signals of its parts, so reading it doesn't need any parsing */
+typedef struct
+	{
+		guint32 julian;       /* GDate's julian day */
+		guint seconds : 17;   /* seconds of the day */
+		guint valid : 1;      /* TRUE if julian is a valid date */
+	} GtkDateEntryValue;
+
+
+G_GNUC_INTERNAL const gchar *_gtk_date_entry_intern_format (const gchar *format);
+G_GNUC_INTERNAL const gchar *_gtk_date_entry_intern_separator (const gchar *separator);
+
+G_GNUC_INTERNAL GtkDateFormat *_gtk_date_entry_ref_locale_format (void);
+G_GNUC_INTERNAL GTimeZone *_gtk_date_entry_get_local_time_zone (void);
+G_GNUC_INTERNAL GtkDateFormat *_gtk_date_entry_get_sql_format (void);
+
+/* conversions of a julian day and the seconds of the day; a NULL time
+ * zone is UTC */
+G_GNUC_INTERNAL gint64 _gtk_date_entry_local_to_utc (GTimeZone *tz,
+                                                     gint64 local);
+G_GNUC_INTERNAL gint64 _gtk_date_entry_utc_to_local (GTimeZone *tz,
+                                                     gint64 utc);
+G_GNUC_INTERNAL gint64 _gtk_date_entry_value_to_unix_usec (GTimeZone *tz,
+                                                           guint32 julian,
+                                                           gint32 seconds);
+G_GNUC_INTERNAL void _gtk_date_entry_unix_usec_to_value (GTimeZone *tz,
+                                                         gint64 usec,
+                                                         gint32 *julian,
+                                                         gint32 *seconds);
+G_GNUC_INTERNAL struct tm *_gtk_date_entry_value_to_tm (guint32 julian,
+                                                        gint32 seconds);
+G_GNUC_INTERNAL void _gtk_date_entry_tm_to_value (const struct tm *tmdate,
+                                                  gint32 *julian,
+                                                  gint32 *seconds);
+G_GNUC_INTERNAL GDateTime *_gtk_date_entry_value_to_gdatetime (GTimeZone *tz,
+                                                               guint32 julian,
+                                                               gint32 seconds);
+G_GNUC_INTERNAL void _gtk_date_entry_gdatetime_to_value (const GDateTime *gdatetime,
+                                                         gint32 *julian,
+                                                         gint32 *seconds);
+
+/* the allowed days: bounds of 0 are open, NULL rules allow every day */
+G_GNUC_INTERNAL gint32 _gtk_date_entry_clamp_julian (guint32 min_julian,
+                                                     guint32 max_julian,
+                                                     gint32 julian);
+G_GNUC_INTERNAL gboolean _gtk_date_entry_is_allowed (guint32 min_julian,
+                                                     guint32 max_julian,
+                                                     GtkDateCalendarRules *rules,
+                                                     guint32 julian);
+G_GNUC_INTERNAL guint32 _gtk_date_entry_next_business_day (guint32 min_julian,
+                                                           guint32 max_julian,
+                                                           GtkDateCalendarRules *rules,
+                                                           guint32 julian);
+
+G_GNUC_INTERNAL void _gtk_date_entry_stop_editing (GtkDateEntry *date);
+
+
+G_END_DECLS
+
+#endif /* __GTK_DATE_ENTRY_PRIVATE_H__ */
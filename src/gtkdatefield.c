@@ -0,0 +1,2659 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+	#include <config.h>
+#endif
+
+#include <string.h>
+
+#include <gdk/gdkkeysyms.h>
+#include <gtk/gtk.h>
+
+#include <libgdaex/queryeditor_widget_interface.h>
+
+#include "gtkdatefield.h"
+#include "gtkdateentryprivate.h"
+
+enum
+{
+	PROP_0,
+	PROP_SEPARATOR,
+	PROP_TIME_SEPARATOR,
+	PROP_FORMAT,
+	PROP_EDITABLE,
+	PROP_DATE_VISIBLE,
+	PROP_TIME_VISIBLE,
+	PROP_TIME_WITH_SECONDS,
+	PROP_JULIAN,
+	PROP_SECONDS,
+	PROP_TIMEZONE,
+	PROP_UTC,
+	PROP_MIN_DATE,
+	PROP_MAX_DATE,
+	PROP_CALENDAR_RULES
+};
+
+enum
+{
+	VALUE_CHANGED,
+	LAST_SIGNAL
+};
+
+/* the fields, in the order of the values in GtkDateFieldPrivate */
+#define GTK_DATE_FIELD_FIELDS "dmYHMS"
+#define GTK_DATE_FIELD_N_FIELDS 6
+
+static void gtk_date_field_class_init (GtkDateFieldClass *klass);
+static void gtk_date_field_init (GtkDateField *field);
+static void gtk_date_field_constructed (GObject *object);
+static void gtk_date_field_finalize (GObject *object);
+
+static void gtk_date_field_gdaex_query_editor_iwidget_interface_init (GdaExQueryEditorIWidgetIface *iface);
+static const gchar *gtk_date_field_get_value (GdaExQueryEditorIWidget *iwidget);
+static const gchar *gtk_date_field_get_value_sql (GdaExQueryEditorIWidget *iwidget);
+static void gtk_date_field_set_value (GdaExQueryEditorIWidget *iwidget,
+                                      const gchar *value);
+
+static void gtk_date_field_set_property (GObject *object,
+                                         guint property_id,
+                                         const GValue *value,
+                                         GParamSpec *pspec);
+static void gtk_date_field_get_property (GObject *object,
+                                         guint property_id,
+                                         GValue *value,
+                                         GParamSpec *pspec);
+
+static void gtk_date_field_realize (GtkWidget *widget);
+static void gtk_date_field_size_allocate (GtkWidget *widget,
+                                          GtkAllocation *allocation);
+static void gtk_date_field_get_preferred_width (GtkWidget *widget,
+                                                gint *minimum_width,
+                                                gint *natural_width);
+static void gtk_date_field_get_preferred_height (GtkWidget *widget,
+                                                 gint *minimum_height,
+                                                 gint *natural_height);
+static void gtk_date_field_style_updated (GtkWidget *widget);
+static gboolean gtk_date_field_draw (GtkWidget *widget,
+                                     cairo_t *cr);
+static gboolean gtk_date_field_focus (GtkWidget *widget,
+                                      GtkDirectionType direction);
+static gboolean gtk_date_field_focus_out_event (GtkWidget *widget,
+                                                GdkEventFocus *event);
+static gboolean gtk_date_field_key_press_event (GtkWidget *widget,
+                                                GdkEventKey *event);
+static gboolean gtk_date_field_button_press_event (GtkWidget *widget,
+                                                   GdkEventButton *event);
+
+static void gtk_date_field_get_size (GtkDateField *field,
+                                     gint *width,
+                                     gint *height);
+static void gtk_date_field_compile_format (GtkDateField *field);
+static void gtk_date_field_update_text (GtkDateField *field);
+static PangoLayout *gtk_date_field_get_layout (GtkDateField *field);
+static void gtk_date_field_get_text_origin (GtkDateField *field,
+                                            gint *x,
+                                            gint *y);
+static gint gtk_date_field_get_segment_field (GtkDateField *field,
+                                              guint segment);
+static void gtk_date_field_move_segment (GtkDateField *field,
+                                         gint segment);
+static gint gtk_date_field_get_max (GtkDateField *field,
+                                    gint i);
+static void gtk_date_field_type_digit (GtkDateField *field,
+                                       gint digit);
+static void gtk_date_field_step (GtkDateField *field,
+                                 gint delta);
+static void gtk_date_field_clear_segment (GtkDateField *field);
+static void gtk_date_field_update_value (GtkDateField *field);
+static void gtk_date_field_emit_value_changed (GtkDateField *field);
+static void gtk_date_field_set_value_julian (GtkDateField *field,
+                                             gint32 julian,
+                                             gint32 seconds);
+static void gtk_date_field_set_bounds (GtkDateField *field,
+                                       guint32 min_julian,
+                                       guint32 max_julian);
+static GTimeZone *gtk_date_field_get_conversion_zone (GtkDateField *field);
+static GtkDateFormat *gtk_date_field_get_strf_format (GtkDateField *field,
+                                                      const gchar *format,
+                                                      const gchar *separator,
+                                                      const gchar *time_separator);
+static gsize gtk_date_field_write (GtkDateField *field,
+                                   const GtkDateFormat *fmt,
+                                   gchar *buf,
+                                   gsize len);
+static gchar *gtk_date_field_get_buffer (GtkDateField *field,
+                                         gsize len);
+
+static void rules_on_changed (GtkDateCalendarRules *rules,
+                              gpointer user_data);
+
+static GtkWidgetClass *parent_class = NULL;
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+
+#define GTK_DATE_FIELD_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE ((obj), GTK_TYPE_DATE_FIELD, GtkDateFieldPrivate))
+
+typedef struct _GtkDateFieldPrivate GtkDateFieldPrivate;
+struct _GtkDateFieldPrivate
+	{
+		const gchar *separator;
+		const gchar *time_separator;
+		const gchar *format;
+
+		gboolean editable;
+		gboolean date_is_visible;
+		gboolean time_is_visible;
+		gboolean time_with_seconds;
+
+		/* FALSE while the construct properties are set */
+		gboolean constructed;
+
+		/* the date's format followed by the visible time's fields: its
+		 * fields are the segments */
+		GtkDateFormat *compiled;
+
+		GtkDateEntryValue value;
+
+		/* TRUE if the date's segments are all filled, also when they
+		 * don't make an allowed date */
+		gboolean complete;
+
+		/* the time zone of the shown value, NULL for the local one, and
+		 * the UTC mode, which doesn't look up any zone */
+		GTimeZone *tz;
+		gboolean utc;
+
+		/* the allowed dates, as in GtkDateEntry: bounds of 0 are open */
+		guint32 min_julian;
+		guint32 max_julian;
+		GtkDateCalendarRules *rules;
+		gulong rules_changed_id;
+
+		/* the value of the last "value-changed", and the number of
+		 * gtk_date_field_freeze_value_changed() not thawed yet */
+		gint64 packed;
+		guint freeze_count;
+
+		/* the last format given to get_strf or set_date_strf, and the
+		 * buffer returned by get_strf and get_sql */
+		GtkDateFormat *strf_format;
+		gchar *buffer;
+		gsize buffer_len;
+
+		/* the segments' values, in the order of GTK_DATE_FIELD_FIELDS;
+		 * -1 if empty */
+		gint fields[GTK_DATE_FIELD_N_FIELDS];
+
+		/* the segment being edited and the digits typed in it */
+		guint segment;
+		guint typed;
+
+		/* the shown text, and its layout: it is built once and only its
+		 * text changes with the value; it is dropped when the style or
+		 * the font change */
+		gchar text[64];
+		PangoLayout *layout;
+
+		/* the size request: it changes only with the format, the visible
+		 * parts and the style, not with the value */
+		gboolean size_valid;
+		gint size_width;
+		gint size_height;
+	};
+
+static const gint field_min[GTK_DATE_FIELD_N_FIELDS] = { 1, 1, 1, 0, 0, 0 };
+static const gint field_max[GTK_DATE_FIELD_N_FIELDS] = { 31, 12, 9999, 23, 59, 59 };
+
+G_DEFINE_TYPE_WITH_CODE (GtkDateField, gtk_date_field, GTK_TYPE_WIDGET,
+                         G_IMPLEMENT_INTERFACE (GDAEX_QUERY_EDITOR_TYPE_IWIDGET,
+                                                gtk_date_field_gdaex_query_editor_iwidget_interface_init));
+
+static void
+gtk_date_field_class_init (GtkDateFieldClass *klass)
+{
+	GtkWidgetClass *widget_class;
+
+	GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+	g_type_class_add_private (object_class, sizeof (GtkDateFieldPrivate));
+
+	widget_class = (GtkWidgetClass*) klass;
+	parent_class = g_type_class_peek_parent (klass);
+
+	object_class->set_property = gtk_date_field_set_property;
+	object_class->get_property = gtk_date_field_get_property;
+	object_class->constructed = gtk_date_field_constructed;
+	object_class->finalize = gtk_date_field_finalize;
+
+	widget_class->realize = gtk_date_field_realize;
+	widget_class->size_allocate = gtk_date_field_size_allocate;
+	widget_class->get_preferred_width = gtk_date_field_get_preferred_width;
+	widget_class->get_preferred_height = gtk_date_field_get_preferred_height;
+	widget_class->style_updated = gtk_date_field_style_updated;
+	widget_class->draw = gtk_date_field_draw;
+	widget_class->focus = gtk_date_field_focus;
+	widget_class->focus_out_event = gtk_date_field_focus_out_event;
+	widget_class->key_press_event = gtk_date_field_key_press_event;
+	widget_class->button_press_event = gtk_date_field_button_press_event;
+
+	g_object_class_install_property (object_class, PROP_SEPARATOR,
+	                                 g_param_spec_string ("separator",
+	                                                      "The separator",
+	                                                      "The separator between day, month and year; NULL for the locale's one.",
+	                                                      NULL,
+	                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+	g_object_class_install_property (object_class, PROP_TIME_SEPARATOR,
+	                                 g_param_spec_string ("time-separator",
+	                                                      "The time separator",
+	                                                      "The separator between hours, minutes and seconds.",
+	                                                      ":",
+	                                                      G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_FORMAT,
+	                                 g_param_spec_string ("format",
+	                                                      "The date's format",
+	                                                      "The date's format; NULL for the locale's one.",
+	                                                      NULL,
+	                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+	g_object_class_install_property (object_class, PROP_EDITABLE,
+	                                 g_param_spec_boolean ("editable",
+	                                                       "TRUE if it is editable",
+	                                                       "Determines if the user can edit the value.",
+	                                                       TRUE,
+	                                                       G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_DATE_VISIBLE,
+	                                 g_param_spec_boolean ("date-visible",
+	                                                       "TRUE to show the date part",
+	                                                       "Determines if the date part of the widget is visible or not.",
+	                                                       TRUE,
+	                                                       G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_TIME_VISIBLE,
+	                                 g_param_spec_boolean ("time-visible",
+	                                                       "TRUE to show the time part",
+	                                                       "Determines if the time part of the widget is visible or not.",
+	                                                       TRUE,
+	                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+	g_object_class_install_property (object_class, PROP_TIME_WITH_SECONDS,
+	                                 g_param_spec_boolean ("time-with-seconds",
+	                                                       "TRUE to show the seconds in time part",
+	                                                       "Determines if the seconds in the time part of the widget are visible or not.",
+	                                                       TRUE,
+	                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
+
+	g_object_class_install_property (object_class, PROP_JULIAN,
+	                                 g_param_spec_uint ("julian",
+	                                                    "The date as a julian day",
+	                                                    "The date as a GDate's julian day; 0 if it isn't valid.",
+	                                                    0,
+	                                                    G_MAXINT32,
+	                                                    0,
+	                                                    G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_SECONDS,
+	                                 g_param_spec_int ("seconds",
+	                                                   "The seconds of the day",
+	                                                   "The time as seconds since midnight.",
+	                                                   0,
+	                                                   86399,
+	                                                   0,
+	                                                   G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_TIMEZONE,
+	                                 g_param_spec_boxed ("timezone",
+	                                                     "The time zone",
+	                                                     "The time zone of the shown date and time; NULL for the local one.",
+	                                                     G_TYPE_TIME_ZONE,
+	                                                     G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_UTC,
+	                                 g_param_spec_boolean ("utc",
+	                                                       "TRUE to show UTC",
+	                                                       "Determines if the shown date and time are in UTC.",
+	                                                       FALSE,
+	                                                       G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_MIN_DATE,
+	                                 g_param_spec_uint ("min-date",
+	                                                    "The first allowed date",
+	                                                    "The first allowed date as a GDate's julian day; 0 for no bound.",
+	                                                    0,
+	                                                    G_MAXINT32,
+	                                                    0,
+	                                                    G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_MAX_DATE,
+	                                 g_param_spec_uint ("max-date",
+	                                                    "The last allowed date",
+	                                                    "The last allowed date as a GDate's julian day; 0 for no bound.",
+	                                                    0,
+	                                                    G_MAXINT32,
+	                                                    0,
+	                                                    G_PARAM_READWRITE));
+
+	g_object_class_install_property (object_class, PROP_CALENDAR_RULES,
+	                                 g_param_spec_object ("calendar-rules",
+	                                                      "The business days",
+	                                                      "The rules of the business days; NULL if all days are allowed.",
+	                                                      GTK_TYPE_DATE_CALENDAR_RULES,
+	                                                      G_PARAM_READWRITE));
+
+	/**
+	 * GtkDateField::value-changed:
+	 * @field: the #GtkDateField.
+	 * @packed: the new value, as returned by gtk_date_field_get_packed().
+	 *
+	 * The same as #GtkDateEntry::value-changed.
+	 */
+	signals[VALUE_CHANGED] = g_signal_new ("value-changed",
+	                                       G_TYPE_FROM_CLASS (object_class),
+	                                       G_SIGNAL_RUN_LAST,
+	                                       0,
+	                                       NULL, NULL,
+	                                       g_cclosure_marshal_generic,
+	                                       G_TYPE_NONE,
+	                                       1, G_TYPE_INT64);
+}
+
+static void
+gtk_date_field_gdaex_query_editor_iwidget_interface_init (GdaExQueryEditorIWidgetIface *iface)
+{
+	iface->get_value = gtk_date_field_get_value;
+	iface->get_value_sql = gtk_date_field_get_value_sql;
+	iface->set_value = gtk_date_field_set_value;
+}
+
+static void
+gtk_date_field_init (GtkDateField *field)
+{
+	guint i;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	gtk_widget_set_has_window (GTK_WIDGET (field), TRUE);
+	gtk_widget_set_can_focus (GTK_WIDGET (field), TRUE);
+
+	/* drawn as an entry */
+	gtk_style_context_add_class (gtk_widget_get_style_context (GTK_WIDGET (field)),
+	                             GTK_STYLE_CLASS_ENTRY);
+
+	/* the format and the separator are set by the construct properties,
+	 * and the format is compiled once in constructed */
+	priv->format = NULL;
+	priv->separator = NULL;
+	priv->time_separator = g_intern_static_string (":");
+
+	priv->editable = TRUE;
+	priv->date_is_visible = TRUE;
+	priv->time_is_visible = TRUE;
+	priv->time_with_seconds = TRUE;
+
+	for (i = 0; i < GTK_DATE_FIELD_N_FIELDS; i++)
+		{
+			priv->fields[i] = -1;
+		}
+}
+
+static void
+gtk_date_field_constructed (GObject *object)
+{
+	GtkDateFormat *fmt;
+
+	GtkDateField *field = GTK_DATE_FIELD (object);
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (G_OBJECT_CLASS (parent_class)->constructed != NULL)
+		{
+			G_OBJECT_CLASS (parent_class)->constructed (object);
+		}
+
+	if (priv->format == NULL || priv->separator == NULL)
+		{
+			fmt = _gtk_date_entry_ref_locale_format ();
+			if (priv->format == NULL)
+				{
+					priv->format = gtk_date_format_get_format (fmt);
+				}
+			if (priv->separator == NULL)
+				{
+					priv->separator = gtk_date_format_get_separator (fmt);
+				}
+			gtk_date_format_unref (fmt);
+		}
+
+	priv->constructed = TRUE;
+
+	gtk_date_field_compile_format (field);
+}
+
+static void
+gtk_date_field_finalize (GObject *object)
+{
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (object);
+
+	if (priv->compiled != NULL)
+		{
+			gtk_date_format_unref (priv->compiled);
+		}
+	if (priv->strf_format != NULL)
+		{
+			gtk_date_format_unref (priv->strf_format);
+		}
+	g_free (priv->buffer);
+	g_clear_object (&priv->layout);
+
+	if (priv->rules != NULL)
+		{
+			g_signal_handler_disconnect (priv->rules, priv->rules_changed_id);
+			g_object_unref (priv->rules);
+		}
+	if (priv->tz != NULL)
+		{
+			g_time_zone_unref (priv->tz);
+		}
+
+	G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+/**
+ * gtk_date_field_new:
+ * @format: (allow-none): the date's format, as in gtk_date_entry_new();
+ * NULL for the locale's one.
+ * @separator: (allow-none): the separator between day, month and year;
+ * NULL for the locale's one.
+ *
+ * Creates a date and time field drawn as one widget: a lighter alternative
+ * to #GtkDateEntry for forms with many dates. It has no calendar's popup;
+ * the segments are edited with the keyboard: digits, Up and Down to change
+ * the value, Left and Right to move, Backspace and Delete to clear.
+ *
+ * Its value API is the one of #GtkDateEntry, on the same conversions,
+ * bounds and calendar's rules, and it implements #GdaExQueryEditorIWidget;
+ * only the editing of the segments is its own.
+ *
+ * Returns: the newly created #GtkDateField; NULL if @format or @separator
+ * aren't valid.
+ */
+GtkWidget
+*gtk_date_field_new (const gchar *format,
+                     const gchar *separator)
+{
+	if ((format != NULL && _gtk_date_entry_intern_format (format) == NULL)
+	    || (separator != NULL && _gtk_date_entry_intern_separator (separator) == NULL))
+		{
+			return NULL;
+		}
+
+	return GTK_WIDGET (g_object_new (gtk_date_field_get_type (),
+	                                 "format", format,
+	                                 "separator", separator,
+	                                 NULL));
+}
+
+/**
+ * gtk_date_field_set_separator:
+ * @field: a #GtkDateField.
+ * @separator: a #gchar that represents the separator between day, month
+ * and year.
+ *
+ * Set the separator between day, month and year.
+ */
+gboolean
+gtk_date_field_set_separator (GtkDateField *field,
+                              const gchar *separator)
+{
+	const gchar *_separator;
+
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	_separator = _gtk_date_entry_intern_separator (separator);
+	if (_separator == NULL)
+		{
+			return FALSE;
+		}
+
+	if (priv->separator == _separator)
+		{
+			return TRUE;
+		}
+
+	priv->separator = _separator;
+	if (priv->constructed)
+		{
+			gtk_date_field_compile_format (field);
+		}
+	g_object_notify (G_OBJECT (field), "separator");
+
+	return TRUE;
+}
+
+/**
+ * gtk_date_field_set_time_separator:
+ * @field: a #GtkDateField.
+ * @separator: a #gchar that represents the separator between hours,
+ * minutes and seconds.
+ *
+ * Set the separator between hours, minutes and seconds.
+ */
+gboolean
+gtk_date_field_set_time_separator (GtkDateField *field,
+                                   const gchar *separator)
+{
+	const gchar *_separator;
+
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	_separator = _gtk_date_entry_intern_separator (separator);
+	if (_separator == NULL)
+		{
+			return FALSE;
+		}
+
+	if (priv->time_separator == _separator)
+		{
+			return TRUE;
+		}
+
+	priv->time_separator = _separator;
+	if (priv->constructed)
+		{
+			gtk_date_field_compile_format (field);
+		}
+	g_object_notify (G_OBJECT (field), "time-separator");
+
+	return TRUE;
+}
+
+/**
+ * gtk_date_field_set_format:
+ * @field: a #GtkDateField.
+ * @format: a #gchar which is the date's format, as in gtk_date_entry_new().
+ *
+ * Set the date's format.
+ */
+gboolean
+gtk_date_field_set_format (GtkDateField *field,
+                           const gchar *format)
+{
+	const gchar *_format;
+
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	_format = _gtk_date_entry_intern_format (format);
+	if (_format == NULL)
+		{
+			return FALSE;
+		}
+
+	if (priv->format == _format)
+		{
+			return TRUE;
+		}
+
+	priv->format = _format;
+	if (priv->constructed)
+		{
+			gtk_date_field_compile_format (field);
+		}
+	g_object_notify (G_OBJECT (field), "format");
+
+	return TRUE;
+}
+
+/**
+ * gtk_date_field_get_text_into:
+ * @field: a #GtkDateField.
+ * @buf: the buffer to write into.
+ * @len: the size of @buf.
+ *
+ * Writes the @field's value, in the @field's format, into @buf without
+ * allocating memory.
+ *
+ * Returns: the length of the text, without the terminating nul; 0 if the
+ * value isn't valid. If it isn't less than @len, @buf isn't big enough and
+ * it is left empty.
+ */
+gsize
+gtk_date_field_get_text_into (GtkDateField *field,
+                              gchar *buf,
+                              gsize len)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), 0);
+	g_return_val_if_fail (buf != NULL || len == 0, 0);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return gtk_date_format_format (priv->compiled,
+	                               priv->value.valid ? priv->value.julian : 0,
+	                               priv->value.seconds,
+	                               buf, len);
+}
+
+/**
+ * gtk_date_field_dup_text:
+ * @field: a #GtkDateField.
+ *
+ * Returns: (transfer full): the @field's value in the @field's format; an
+ * empty string if it isn't valid. Free it with g_free().
+ */
+gchar
+*gtk_date_field_dup_text (GtkDateField *field)
+{
+	gchar buf[64];
+
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), NULL);
+
+	gtk_date_field_get_text_into (field, buf, sizeof (buf));
+
+	return g_strdup (buf);
+}
+
+/**
+ * gtk_date_field_get_strf:
+ * @field: a #GtkDateField.
+ * @format: (allow-none): a #gchar which is the date's format, as in
+ * gtk_date_entry_get_strf(); NULL for the @field's one.
+ * @separator: (allow-none): the string between day, month and year.
+ * @time_separator: (allow-none): the string between hours, minutes and
+ * seconds.
+ *
+ * Returns: (transfer none): the @field's value formatted as specified in
+ * @format; it is owned by @field and it is valid until the next call of
+ * gtk_date_field_get_strf() or gtk_date_field_get_sql().
+ */
+const gchar
+*gtk_date_field_get_strf (GtkDateField *field,
+                          const gchar *format,
+                          const gchar *separator,
+                          const gchar *time_separator)
+{
+	GtkDateFormat *fmt;
+	gsize len;
+
+	GtkDateFieldPrivate *priv;
+
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), "");
+
+	priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	fmt = gtk_date_field_get_strf_format (field, format, separator, time_separator);
+
+	len = gtk_date_format_get_width (fmt) + 1;
+	gtk_date_field_write (field, fmt, gtk_date_field_get_buffer (field, len), len);
+
+	return priv->buffer;
+}
+
+/**
+ * gtk_date_field_get_sql:
+ * @field: a #GtkDateField.
+ *
+ * Returns: (transfer none): the @field's value formatted for sql, as
+ * gtk_date_entry_get_sql(); it is valid as the one of
+ * gtk_date_field_get_strf().
+ */
+const gchar
+*gtk_date_field_get_sql (GtkDateField *field)
+{
+	gsize len;
+
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), "");
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	len = gtk_date_format_get_width (_gtk_date_entry_get_sql_format ()) + 1;
+	gtk_date_field_write (field, _gtk_date_entry_get_sql_format (),
+	                      gtk_date_field_get_buffer (field, len), len);
+
+	return priv->buffer;
+}
+
+/**
+ * gtk_date_field_get_tm:
+ * @field: a #GtkDateField.
+ *
+ * Returns: (transfer full): the @field's value as a struct tm; NULL if it
+ * isn't valid. Free it with g_free().
+ */
+struct tm
+*gtk_date_field_get_tm (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), NULL);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (!priv->value.valid)
+		{
+			return NULL;
+		}
+
+	return _gtk_date_entry_value_to_tm (priv->value.julian, priv->value.seconds);
+}
+
+/**
+ * gtk_date_field_get_gdate:
+ * @field: a #GtkDateField.
+ *
+ * Returns: (transfer full): the @field's date as a #GDate; NULL if it
+ * isn't valid.
+ */
+GDate
+*gtk_date_field_get_gdate (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), NULL);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (!priv->value.valid)
+		{
+			return NULL;
+		}
+
+	return g_date_new_julian (priv->value.julian);
+}
+
+/**
+ * gtk_date_field_get_gdatetime:
+ * @field: a #GtkDateField.
+ *
+ * Returns: (transfer full): the @field's value as a #GDateTime in the
+ * @field's time zone; NULL if it isn't valid.
+ */
+GDateTime
+*gtk_date_field_get_gdatetime (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), NULL);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (!priv->value.valid)
+		{
+			return NULL;
+		}
+
+	return _gtk_date_entry_value_to_gdatetime (gtk_date_field_get_conversion_zone (field),
+	                                           priv->value.julian,
+	                                           priv->value.seconds);
+}
+
+/**
+ * gtk_date_field_set_date_strf:
+ * @field: a #GtkDateField.
+ * @str: the text to parse.
+ * @format: (allow-none): a #gchar which is the @str's format; NULL for the
+ * @field's one.
+ *
+ * Sets the @field's value from @str.
+ *
+ * Returns: FALSE if @str isn't a valid date in @format; then @field is
+ * cleared.
+ */
+gboolean
+gtk_date_field_set_date_strf (GtkDateField *field,
+                              const gchar *str,
+                              const gchar *format)
+{
+	gint32 julian;
+	gint32 seconds;
+	gboolean ret;
+
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	ret = gtk_date_format_parse (gtk_date_field_get_strf_format (field, format, NULL, NULL),
+	                             str, &julian, &seconds);
+	gtk_date_field_set_value_julian (field, ret ? julian : 0, ret ? seconds : 0);
+
+	return ret;
+}
+
+/**
+ * gtk_date_field_set_sql:
+ * @field: a #GtkDateField.
+ * @str: (allow-none): a date or a timestamp formatted for sql; NULL or
+ * empty to clear @field.
+ *
+ * The same as gtk_date_entry_set_sql().
+ *
+ * Returns: FALSE if @str isn't a valid date; then @field is cleared.
+ */
+gboolean
+gtk_date_field_set_sql (GtkDateField *field,
+                        const gchar *str)
+{
+	gint32 julian;
+	gint32 seconds;
+	gboolean ret;
+
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	if (str == NULL || str[0] == '\0')
+		{
+			gtk_date_field_set_value_julian (field, 0, 0);
+			return TRUE;
+		}
+
+	ret = gtk_date_format_parse (_gtk_date_entry_get_sql_format (), str, &julian, &seconds);
+	gtk_date_field_set_value_julian (field, ret ? julian : 0, ret ? seconds : 0);
+
+	return ret;
+}
+
+/**
+ * gtk_date_field_set_date_tm:
+ * @field: a #GtkDateField.
+ * @tmdate: a tm struct from which set @field's value.
+ *
+ * Sets the @field's value; a date or a time out of range clears it.
+ */
+void
+gtk_date_field_set_date_tm (GtkDateField *field,
+                            const struct tm tmdate)
+{
+	gint32 julian;
+	gint32 seconds;
+
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	_gtk_date_entry_tm_to_value (&tmdate, &julian, &seconds);
+	gtk_date_field_set_value_julian (field, julian, seconds);
+}
+
+/**
+ * gtk_date_field_set_date_gdate:
+ * @field: a #GtkDateField.
+ * @gdate: (allow-none): a #GDate; NULL clears the value.
+ *
+ * Sets the @field's date; the time doesn't change.
+ */
+void
+gtk_date_field_set_date_gdate (GtkDateField *field,
+                               const GDate *gdate)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	gtk_date_field_set_value_julian (field,
+	                                 gdate != NULL && g_date_valid (gdate) ? g_date_get_julian (gdate) : 0,
+	                                 priv->value.seconds);
+}
+
+/**
+ * gtk_date_field_set_date_gdatetime:
+ * @field: a #GtkDateField.
+ * @gdatetime: (allow-none): a #GDateTime; NULL clears the value.
+ *
+ * Sets the @field's value to the date and time of @gdatetime, in its own
+ * time zone.
+ */
+void
+gtk_date_field_set_date_gdatetime (GtkDateField *field,
+                                   const GDateTime *gdatetime)
+{
+	gint32 julian;
+	gint32 seconds;
+
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	_gtk_date_entry_gdatetime_to_value (gdatetime, &julian, &seconds);
+	gtk_date_field_set_value_julian (field, julian, seconds);
+}
+
+/**
+ * gtk_date_field_is_valid:
+ * @field: a #GtkDateField.
+ *
+ * Returns: TRUE if all the date's segments are filled with an allowed date.
+ */
+gboolean
+gtk_date_field_is_valid (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->value.valid;
+}
+
+/**
+ * gtk_date_field_is_complete:
+ * @field: a #GtkDateField.
+ *
+ * Returns: TRUE if all the date's segments are filled, also if they don't
+ * make an allowed date.
+ */
+gboolean
+gtk_date_field_is_complete (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->complete;
+}
+
+/**
+ * gtk_date_field_get_julian:
+ * @field: a #GtkDateField.
+ *
+ * Returns: the date as a GDate's julian day; 0 if it isn't valid.
+ */
+guint32
+gtk_date_field_get_julian (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), 0);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->value.valid ? priv->value.julian : 0;
+}
+
+/**
+ * gtk_date_field_get_seconds:
+ * @field: a #GtkDateField.
+ *
+ * Returns: the time as seconds since midnight; the empty segments count
+ * as 0.
+ */
+gint32
+gtk_date_field_get_seconds (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), 0);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->value.seconds;
+}
+
+/**
+ * gtk_date_field_set_julian_seconds:
+ * @field: a #GtkDateField.
+ * @julian: the date as a GDate's julian day; 0 clears the value.
+ * @seconds: the seconds since midnight.
+ *
+ * Sets the @field's value without building a GDate or a GDateTime.
+ */
+void
+gtk_date_field_set_julian_seconds (GtkDateField *field,
+                                   guint32 julian,
+                                   gint32 seconds)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+	g_return_if_fail (julian <= G_MAXINT32);
+	g_return_if_fail (seconds >= 0 && seconds < 86400);
+
+	gtk_date_field_set_value_julian (field, julian, seconds);
+}
+
+/**
+ * gtk_date_field_get_packed:
+ * @field: a #GtkDateField.
+ *
+ * Returns: the @field's value as GTK_DATE_ENTRY_PACK() of the julian day
+ * and the seconds; 0 if it isn't valid.
+ */
+gint64
+gtk_date_field_get_packed (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), 0);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (!priv->value.valid)
+		{
+			return 0;
+		}
+
+	return GTK_DATE_ENTRY_PACK (priv->value.julian, priv->value.seconds);
+}
+
+/**
+ * gtk_date_field_freeze_value_changed:
+ * @field: a #GtkDateField.
+ *
+ * Stops the emission of #GtkDateField::value-changed, and of the
+ * notifications, until gtk_date_field_thaw_value_changed() is called as
+ * many times.
+ */
+void
+gtk_date_field_freeze_value_changed (GtkDateField *field)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	priv->freeze_count++;
+	g_object_freeze_notify (G_OBJECT (field));
+}
+
+/**
+ * gtk_date_field_thaw_value_changed:
+ * @field: a #GtkDateField.
+ *
+ * Reverts gtk_date_field_freeze_value_changed(); the last one emits
+ * #GtkDateField::value-changed if the value differs from the one of the
+ * last emission.
+ */
+void
+gtk_date_field_thaw_value_changed (GtkDateField *field)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	g_return_if_fail (priv->freeze_count > 0);
+
+	priv->freeze_count--;
+	g_object_thaw_notify (G_OBJECT (field));
+
+	gtk_date_field_emit_value_changed (field);
+}
+
+/**
+ * gtk_date_field_get_unix_usec:
+ * @field: a #GtkDateField.
+ *
+ * Returns: the @field's value, read in the @field's time zone, as
+ * microseconds since 1970-01-01 00:00:00 UTC; G_MININT64 if it isn't
+ * valid.
+ */
+gint64
+gtk_date_field_get_unix_usec (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), G_MININT64);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (!priv->value.valid)
+		{
+			return G_MININT64;
+		}
+
+	return _gtk_date_entry_value_to_unix_usec (gtk_date_field_get_conversion_zone (field),
+	                                           priv->value.julian,
+	                                           priv->value.seconds);
+}
+
+/**
+ * gtk_date_field_set_unix_usec:
+ * @field: a #GtkDateField.
+ * @usec: microseconds since 1970-01-01 00:00:00 UTC; G_MININT64 to clear
+ * @field.
+ *
+ * Sets the @field's value from a unix time, shown in the @field's time
+ * zone; the fraction of second is dropped.
+ */
+void
+gtk_date_field_set_unix_usec (GtkDateField *field,
+                              gint64 usec)
+{
+	gint32 julian;
+	gint32 seconds;
+
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	_gtk_date_entry_unix_usec_to_value (gtk_date_field_get_conversion_zone (field),
+	                                    usec, &julian, &seconds);
+	gtk_date_field_set_value_julian (field, julian, seconds);
+}
+
+/**
+ * gtk_date_field_set_timezone:
+ * @field: a #GtkDateField.
+ * @tz: (allow-none): a #GTimeZone; NULL for the local time zone.
+ *
+ * The same as gtk_date_entry_set_timezone(): the shown value doesn't
+ * change.
+ */
+void
+gtk_date_field_set_timezone (GtkDateField *field,
+                             GTimeZone *tz)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (tz == priv->tz && !priv->utc)
+		{
+			return;
+		}
+
+	if (tz != NULL)
+		{
+			g_time_zone_ref (tz);
+		}
+	if (priv->tz != NULL)
+		{
+			g_time_zone_unref (priv->tz);
+		}
+	priv->tz = tz;
+
+	g_object_notify (G_OBJECT (field), "timezone");
+	if (priv->utc)
+		{
+			priv->utc = FALSE;
+			g_object_notify (G_OBJECT (field), "utc");
+		}
+}
+
+/**
+ * gtk_date_field_get_timezone:
+ * @field: a #GtkDateField.
+ *
+ * Returns: (transfer none): the time zone set with
+ * gtk_date_field_set_timezone(); NULL if @field uses the local time zone or
+ * UTC.
+ */
+GTimeZone
+*gtk_date_field_get_timezone (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), NULL);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->utc ? NULL : priv->tz;
+}
+
+/**
+ * gtk_date_field_set_utc:
+ * @field: a #GtkDateField.
+ * @utc: TRUE if the shown date and time are in UTC.
+ *
+ * The same as gtk_date_entry_set_utc().
+ */
+void
+gtk_date_field_set_utc (GtkDateField *field,
+                        gboolean utc)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (priv->utc == !!utc)
+		{
+			return;
+		}
+
+	priv->utc = !!utc;
+
+	g_object_notify (G_OBJECT (field), "utc");
+	g_object_notify (G_OBJECT (field), "timezone");
+}
+
+/**
+ * gtk_date_field_is_utc:
+ * @field: a #GtkDateField.
+ *
+ * Returns: TRUE if the shown date and time are in UTC.
+ */
+gboolean
+gtk_date_field_is_utc (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->utc;
+}
+
+/**
+ * gtk_date_field_set_min_date:
+ * @field: a #GtkDateField.
+ * @julian: the first allowed date, as a GDate's julian day; 0 for no bound.
+ *
+ * The same as gtk_date_entry_set_min_date(): the setters move the dates
+ * before @julian to it, and the typed ones make @field not valid.
+ */
+void
+gtk_date_field_set_min_date (GtkDateField *field,
+                             guint32 julian)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	gtk_date_field_set_bounds (field, julian, priv->max_julian);
+}
+
+/**
+ * gtk_date_field_get_min_date:
+ * @field: a #GtkDateField.
+ *
+ * Returns: the first allowed date, as a GDate's julian day; 0 if there
+ * isn't a bound.
+ */
+guint32
+gtk_date_field_get_min_date (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), 0);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->min_julian;
+}
+
+/**
+ * gtk_date_field_set_max_date:
+ * @field: a #GtkDateField.
+ * @julian: the last allowed date, as a GDate's julian day; 0 for no bound.
+ *
+ * The same as gtk_date_field_set_min_date(), for the dates after @julian.
+ */
+void
+gtk_date_field_set_max_date (GtkDateField *field,
+                             guint32 julian)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	gtk_date_field_set_bounds (field, priv->min_julian, julian);
+}
+
+/**
+ * gtk_date_field_get_max_date:
+ * @field: a #GtkDateField.
+ *
+ * Returns: the last allowed date, as a GDate's julian day; 0 if there
+ * isn't a bound.
+ */
+guint32
+gtk_date_field_get_max_date (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), 0);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->max_julian;
+}
+
+/**
+ * gtk_date_field_set_calendar_rules:
+ * @field: a #GtkDateField.
+ * @rules: (allow-none): a #GtkDateCalendarRules; NULL to allow all days.
+ *
+ * The days that aren't business days for @rules make @field not valid.
+ * The same @rules can be shared with other fields and entries.
+ */
+void
+gtk_date_field_set_calendar_rules (GtkDateField *field,
+                                   GtkDateCalendarRules *rules)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+	g_return_if_fail (rules == NULL || GTK_IS_DATE_CALENDAR_RULES (rules));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (priv->rules == rules)
+		{
+			return;
+		}
+
+	if (priv->rules != NULL)
+		{
+			g_signal_handler_disconnect (priv->rules, priv->rules_changed_id);
+			g_object_unref (priv->rules);
+		}
+
+	priv->rules = rules;
+	priv->rules_changed_id = 0;
+	if (rules != NULL)
+		{
+			g_object_ref (rules);
+			priv->rules_changed_id = g_signal_connect (rules, "changed",
+			                                           G_CALLBACK (rules_on_changed), field);
+		}
+
+	g_object_freeze_notify (G_OBJECT (field));
+	g_object_notify (G_OBJECT (field), "calendar-rules");
+	gtk_date_field_update_value (field);
+	g_object_thaw_notify (G_OBJECT (field));
+}
+
+/**
+ * gtk_date_field_get_calendar_rules:
+ * @field: a #GtkDateField.
+ *
+ * Returns: (transfer none): the #GtkDateCalendarRules set with
+ * gtk_date_field_set_calendar_rules(); NULL if all days are allowed.
+ */
+GtkDateCalendarRules
+*gtk_date_field_get_calendar_rules (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), NULL);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->rules;
+}
+
+/**
+ * gtk_date_field_next_business_day:
+ * @field: a #GtkDateField.
+ *
+ * The same as gtk_date_entry_next_business_day().
+ *
+ * Returns: FALSE if @field isn't valid, or if the next business day is
+ * after "max-date".
+ */
+gboolean
+gtk_date_field_next_business_day (GtkDateField *field)
+{
+	guint32 julian;
+
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (!priv->value.valid)
+		{
+			return FALSE;
+		}
+
+	julian = _gtk_date_entry_next_business_day (priv->min_julian,
+	                                            priv->max_julian,
+	                                            priv->rules,
+	                                            priv->value.julian);
+	if (julian == 0)
+		{
+			return FALSE;
+		}
+
+	gtk_date_field_set_value_julian (field, julian, priv->value.seconds);
+
+	return TRUE;
+}
+
+/**
+ * gtk_date_field_set_editable:
+ * @field: a #GtkDateField.
+ * @is_editable: TRUE if the user can edit the value.
+ *
+ * Determines if the user can edit the value.
+ */
+void
+gtk_date_field_set_editable (GtkDateField *field,
+                             gboolean is_editable)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	priv->typed = 0;
+	if (priv->editable == !!is_editable)
+		{
+			return;
+		}
+
+	priv->editable = !!is_editable;
+	g_object_notify (G_OBJECT (field), "editable");
+}
+
+/**
+ * gtk_date_field_is_editable:
+ * @field: a #GtkDateField.
+ *
+ * Returns: TRUE if the user can edit the value.
+ */
+gboolean
+gtk_date_field_is_editable (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->editable;
+}
+
+/**
+ * gtk_date_field_set_date_visible:
+ * @field: a #GtkDateField.
+ * @is_visible: TRUE if the date must be visible.
+ *
+ * Determines if the date is visible or not; a hidden date is cleared.
+ */
+void
+gtk_date_field_set_date_visible (GtkDateField *field,
+                                 gboolean is_visible)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (priv->date_is_visible == !!is_visible)
+		{
+			return;
+		}
+
+	priv->date_is_visible = !!is_visible;
+	if (!priv->date_is_visible)
+		{
+			priv->fields[0] = -1;
+			priv->fields[1] = -1;
+			priv->fields[2] = -1;
+		}
+
+	if (priv->constructed)
+		{
+			gtk_date_field_compile_format (field);
+		}
+	g_object_notify (G_OBJECT (field), "date-visible");
+}
+
+/**
+ * gtk_date_field_is_date_visible:
+ * @field: a #GtkDateField.
+ *
+ * Returns: TRUE if the date part is visible.
+ */
+gboolean
+gtk_date_field_is_date_visible (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->date_is_visible;
+}
+
+/**
+ * gtk_date_field_set_time_visible:
+ * @field: a #GtkDateField.
+ * @is_visible: TRUE if the time must be visible.
+ *
+ * Determines if the time is visible or not; a hidden time is 0.
+ */
+void
+gtk_date_field_set_time_visible (GtkDateField *field,
+                                 gboolean is_visible)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (field));
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (priv->time_is_visible == !!is_visible)
+		{
+			return;
+		}
+
+	priv->time_is_visible = !!is_visible;
+	if (priv->constructed)
+		{
+			gtk_date_field_compile_format (field);
+		}
+	g_object_notify (G_OBJECT (field), "time-visible");
+}
+
+/**
+ * gtk_date_field_is_time_visible:
+ * @field: a #GtkDateField.
+ *
+ * Returns: TRUE if the time part is visible.
+ */
+gboolean
+gtk_date_field_is_time_visible (GtkDateField *field)
+{
+	g_return_val_if_fail (GTK_IS_DATE_FIELD (field), FALSE);
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	return priv->time_is_visible;
+}
+
+/* PRIVATE */
+static void
+gtk_date_field_set_property (GObject *object,
+                             guint property_id,
+                             const GValue *value,
+                             GParamSpec *pspec)
+{
+	GtkDateField *field = (GtkDateField *)object;
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	switch (property_id)
+		{
+			case PROP_SEPARATOR:
+				if (g_value_get_string (value) == NULL)
+					{
+						/* NULL is the locale's one; while constructing,
+						 * constructed resolves it */
+						if (priv->constructed)
+							{
+								GtkDateFormat *fmt = _gtk_date_entry_ref_locale_format ();
+								gtk_date_field_set_separator (field, gtk_date_format_get_separator (fmt));
+								gtk_date_format_unref (fmt);
+							}
+					}
+				else
+					{
+						gtk_date_field_set_separator (field, g_value_get_string (value));
+					}
+				break;
+
+			case PROP_TIME_SEPARATOR:
+				gtk_date_field_set_time_separator (field, g_value_get_string (value));
+				break;
+
+			case PROP_FORMAT:
+				if (g_value_get_string (value) == NULL)
+					{
+						if (priv->constructed)
+							{
+								GtkDateFormat *fmt = _gtk_date_entry_ref_locale_format ();
+								gtk_date_field_set_format (field, gtk_date_format_get_format (fmt));
+								gtk_date_format_unref (fmt);
+							}
+					}
+				else
+					{
+						gtk_date_field_set_format (field, g_value_get_string (value));
+					}
+				break;
+
+			case PROP_EDITABLE:
+				gtk_date_field_set_editable (field, g_value_get_boolean (value));
+				break;
+
+			case PROP_DATE_VISIBLE:
+				gtk_date_field_set_date_visible (field, g_value_get_boolean (value));
+				break;
+
+			case PROP_TIME_VISIBLE:
+				gtk_date_field_set_time_visible (field, g_value_get_boolean (value));
+				break;
+
+			case PROP_TIME_WITH_SECONDS:
+				priv->time_with_seconds = g_value_get_boolean (value);
+				if (priv->constructed)
+					{
+						gtk_date_field_compile_format (field);
+					}
+				break;
+
+			case PROP_JULIAN:
+				gtk_date_field_set_julian_seconds (field,
+				                                   g_value_get_uint (value),
+				                                   priv->value.seconds);
+				break;
+
+			case PROP_SECONDS:
+				gtk_date_field_set_julian_seconds (field,
+				                                   gtk_date_field_get_julian (field),
+				                                   g_value_get_int (value));
+				break;
+
+			case PROP_TIMEZONE:
+				gtk_date_field_set_timezone (field, g_value_get_boxed (value));
+				break;
+
+			case PROP_UTC:
+				gtk_date_field_set_utc (field, g_value_get_boolean (value));
+				break;
+
+			case PROP_MIN_DATE:
+				gtk_date_field_set_min_date (field, g_value_get_uint (value));
+				break;
+
+			case PROP_MAX_DATE:
+				gtk_date_field_set_max_date (field, g_value_get_uint (value));
+				break;
+
+			case PROP_CALENDAR_RULES:
+				gtk_date_field_set_calendar_rules (field, g_value_get_object (value));
+				break;
+
+			default:
+				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+				break;
+		}
+}
+
+static void
+gtk_date_field_get_property (GObject *object,
+                             guint property_id,
+                             GValue *value,
+                             GParamSpec *pspec)
+{
+	GtkDateField *field = (GtkDateField *)object;
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	switch (property_id)
+		{
+			case PROP_SEPARATOR:
+				g_value_set_string (value, priv->separator);
+				break;
+
+			case PROP_TIME_SEPARATOR:
+				g_value_set_string (value, priv->time_separator);
+				break;
+
+			case PROP_FORMAT:
+				g_value_set_string (value, priv->format);
+				break;
+
+			case PROP_EDITABLE:
+				g_value_set_boolean (value, priv->editable);
+				break;
+
+			case PROP_DATE_VISIBLE:
+				g_value_set_boolean (value, priv->date_is_visible);
+				break;
+
+			case PROP_TIME_VISIBLE:
+				g_value_set_boolean (value, priv->time_is_visible);
+				break;
+
+			case PROP_TIME_WITH_SECONDS:
+				g_value_set_boolean (value, priv->time_with_seconds);
+				break;
+
+			case PROP_JULIAN:
+				g_value_set_uint (value, gtk_date_field_get_julian (field));
+				break;
+
+			case PROP_SECONDS:
+				g_value_set_int (value, priv->value.seconds);
+				break;
+
+			case PROP_TIMEZONE:
+				g_value_set_boxed (value, gtk_date_field_get_timezone (field));
+				break;
+
+			case PROP_UTC:
+				g_value_set_boolean (value, priv->utc);
+				break;
+
+			case PROP_MIN_DATE:
+				g_value_set_uint (value, priv->min_julian);
+				break;
+
+			case PROP_MAX_DATE:
+				g_value_set_uint (value, priv->max_julian);
+				break;
+
+			case PROP_CALENDAR_RULES:
+				g_value_set_object (value, priv->rules);
+				break;
+
+			default:
+				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+				break;
+		}
+}
+
+static void
+gtk_date_field_realize (GtkWidget *widget)
+{
+	GtkAllocation allocation;
+	GdkWindowAttr attributes;
+	GdkWindow *window;
+
+	gtk_widget_set_realized (widget, TRUE);
+	gtk_widget_get_allocation (widget, &allocation);
+
+	attributes.window_type = GDK_WINDOW_CHILD;
+	attributes.x = allocation.x;
+	attributes.y = allocation.y;
+	attributes.width = allocation.width;
+	attributes.height = allocation.height;
+	attributes.wclass = GDK_INPUT_OUTPUT;
+	attributes.visual = gtk_widget_get_visual (widget);
+	attributes.event_mask = gtk_widget_get_events (widget)
+	                        | GDK_BUTTON_PRESS_MASK
+	                        | GDK_KEY_PRESS_MASK;
+
+	window = gdk_window_new (gtk_widget_get_parent_window (widget),
+	                         &attributes,
+	                         GDK_WA_X | GDK_WA_Y | GDK_WA_VISUAL);
+	gtk_widget_set_window (widget, window);
+	gtk_widget_register_window (widget, window);
+}
+
+static void
+gtk_date_field_size_allocate (GtkWidget *widget,
+                              GtkAllocation *allocation)
+{
+	g_return_if_fail (GTK_IS_DATE_FIELD (widget));
+	g_return_if_fail (allocation != NULL);
+
+	gtk_widget_set_allocation (widget, allocation);
+
+	if (gtk_widget_get_realized (widget))
+		{
+			gdk_window_move_resize (gtk_widget_get_window (widget),
+			                        allocation->x, allocation->y,
+			                        allocation->width, allocation->height);
+		}
+}
+
+/* the size of the template's text, with the padding and the border */
+static void
+gtk_date_field_get_size (GtkDateField *field,
+                         gint *width,
+                         gint *height)
+{
+	GtkStyleContext *context;
+	GtkStateFlags state;
+	GtkBorder padding;
+	GtkBorder border;
+	PangoLayout *layout;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (!priv->size_valid)
+		{
+			context = gtk_widget_get_style_context (GTK_WIDGET (field));
+			state = gtk_widget_get_state_flags (GTK_WIDGET (field));
+			gtk_style_context_get_padding (context, state, &padding);
+			gtk_style_context_get_border (context, state, &border);
+
+			layout = gtk_widget_create_pango_layout (GTK_WIDGET (field),
+			                                         gtk_date_format_get_template (priv->compiled));
+			pango_layout_get_pixel_size (layout, &priv->size_width, &priv->size_height);
+			g_object_unref (layout);
+
+			priv->size_width += padding.left + padding.right + border.left + border.right;
+			priv->size_height += padding.top + padding.bottom + border.top + border.bottom;
+			priv->size_valid = TRUE;
+		}
+
+	*width = priv->size_width;
+	*height = priv->size_height;
+}
+
+static void
+gtk_date_field_get_preferred_width (GtkWidget *widget,
+                                    gint *minimum_width,
+                                    gint *natural_width)
+{
+	gint width;
+	gint height;
+
+	g_return_if_fail (GTK_IS_DATE_FIELD (widget));
+	g_return_if_fail (minimum_width != NULL);
+	g_return_if_fail (natural_width != NULL);
+
+	gtk_date_field_get_size (GTK_DATE_FIELD (widget), &width, &height);
+
+	*minimum_width = width;
+	*natural_width = width;
+}
+
+static void
+gtk_date_field_get_preferred_height (GtkWidget *widget,
+                                     gint *minimum_height,
+                                     gint *natural_height)
+{
+	gint width;
+	gint height;
+
+	g_return_if_fail (GTK_IS_DATE_FIELD (widget));
+	g_return_if_fail (minimum_height != NULL);
+	g_return_if_fail (natural_height != NULL);
+
+	gtk_date_field_get_size (GTK_DATE_FIELD (widget), &width, &height);
+
+	*minimum_height = height;
+	*natural_height = height;
+}
+
+static void
+gtk_date_field_style_updated (GtkWidget *widget)
+{
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (widget);
+
+	if (GTK_WIDGET_CLASS (parent_class)->style_updated != NULL)
+		{
+			GTK_WIDGET_CLASS (parent_class)->style_updated (widget);
+		}
+
+	/* the font, the padding or the theme changed */
+	g_clear_object (&priv->layout);
+	priv->size_valid = FALSE;
+	gtk_widget_queue_resize (widget);
+}
+
+static gboolean
+gtk_date_field_draw (GtkWidget *widget,
+                     cairo_t *cr)
+{
+	GtkStyleContext *context;
+	PangoLayout *layout;
+	PangoRectangle start;
+	PangoRectangle end;
+	guint offset;
+	guint width;
+	gint x;
+	gint y;
+	gint text_height;
+
+	GtkDateField *field = GTK_DATE_FIELD (widget);
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	context = gtk_widget_get_style_context (widget);
+
+	gtk_render_background (context, cr, 0, 0,
+	                       gtk_widget_get_allocated_width (widget),
+	                       gtk_widget_get_allocated_height (widget));
+	gtk_render_frame (context, cr, 0, 0,
+	                  gtk_widget_get_allocated_width (widget),
+	                  gtk_widget_get_allocated_height (widget));
+
+	layout = gtk_date_field_get_layout (field);
+	gtk_date_field_get_text_origin (field, &x, &y);
+	gtk_render_layout (context, cr, x, y, layout);
+
+	/* the segment being edited is drawn as selected text */
+	if (gtk_widget_has_focus (widget)
+	    && gtk_date_format_get_field (priv->compiled, priv->segment, &offset, &width) != 0)
+		{
+			pango_layout_index_to_pos (layout, offset, &start);
+			pango_layout_index_to_pos (layout, offset + width - 1, &end);
+			pango_layout_get_pixel_size (layout, NULL, &text_height);
+
+			start.x = PANGO_PIXELS (start.x);
+			end.x = PANGO_PIXELS (end.x + end.width);
+
+			cairo_save (cr);
+			cairo_rectangle (cr, x + start.x, y, end.x - start.x, text_height);
+			cairo_clip (cr);
+
+			gtk_style_context_save (context);
+			gtk_style_context_add_class (context, GTK_STYLE_CLASS_VIEW);
+			gtk_style_context_set_state (context,
+			                             gtk_style_context_get_state (context) | GTK_STATE_FLAG_SELECTED);
+			gtk_render_background (context, cr, x + start.x, y, end.x - start.x, text_height);
+			gtk_render_layout (context, cr, x, y, layout);
+			gtk_style_context_restore (context);
+
+			cairo_restore (cr);
+		}
+
+	return FALSE;
+}
+
+static gboolean
+gtk_date_field_focus (GtkWidget *widget,
+                      GtkDirectionType direction)
+{
+	guint n_segments;
+
+	GtkDateField *field = GTK_DATE_FIELD (widget);
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	n_segments = gtk_date_format_get_n_fields (priv->compiled);
+	if (n_segments == 0 || !gtk_widget_is_sensitive (widget))
+		{
+			return FALSE;
+		}
+
+	/* Tab moves between the segments before leaving the field */
+	if (!gtk_widget_has_focus (widget))
+		{
+			gtk_date_field_move_segment (field,
+			                             direction == GTK_DIR_TAB_BACKWARD ? n_segments - 1 : 0);
+			gtk_widget_grab_focus (widget);
+			return TRUE;
+		}
+
+	switch (direction)
+		{
+			case GTK_DIR_TAB_FORWARD:
+				if (priv->segment + 1 < n_segments)
+					{
+						gtk_date_field_move_segment (field, priv->segment + 1);
+						return TRUE;
+					}
+				break;
+
+			case GTK_DIR_TAB_BACKWARD:
+				if (priv->segment > 0)
+					{
+						gtk_date_field_move_segment (field, priv->segment - 1);
+						return TRUE;
+					}
+				break;
+
+			default:
+				break;
+		}
+
+	return FALSE;
+}
+
+static gboolean
+gtk_date_field_focus_out_event (GtkWidget *widget,
+                                GdkEventFocus *event)
+{
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (widget);
+
+	priv->typed = 0;
+	gtk_widget_queue_draw (widget);
+
+	return GTK_WIDGET_CLASS (parent_class)->focus_out_event (widget, event);
+}
+
+static gboolean
+gtk_date_field_key_press_event (GtkWidget *widget,
+                                GdkEventKey *event)
+{
+	gunichar c;
+
+	GtkDateField *field = GTK_DATE_FIELD (widget);
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	switch (event->keyval)
+		{
+			case GDK_KEY_Left:
+			case GDK_KEY_KP_Left:
+				gtk_date_field_move_segment (field, (gint)priv->segment - 1);
+				return TRUE;
+
+			case GDK_KEY_Right:
+			case GDK_KEY_KP_Right:
+				gtk_date_field_move_segment (field, priv->segment + 1);
+				return TRUE;
+
+			case GDK_KEY_Home:
+			case GDK_KEY_KP_Home:
+				gtk_date_field_move_segment (field, 0);
+				return TRUE;
+
+			case GDK_KEY_End:
+			case GDK_KEY_KP_End:
+				gtk_date_field_move_segment (field, (gint)gtk_date_format_get_n_fields (priv->compiled) - 1);
+				return TRUE;
+
+			case GDK_KEY_Up:
+			case GDK_KEY_KP_Up:
+				if (priv->editable)
+					{
+						gtk_date_field_step (field, 1);
+					}
+				return TRUE;
+
+			case GDK_KEY_Down:
+			case GDK_KEY_KP_Down:
+				if (priv->editable)
+					{
+						gtk_date_field_step (field, -1);
+					}
+				return TRUE;
+
+			case GDK_KEY_BackSpace:
+			case GDK_KEY_Delete:
+			case GDK_KEY_KP_Delete:
+				if (priv->editable)
+					{
+						gtk_date_field_clear_segment (field);
+					}
+				return TRUE;
+
+			default:
+				break;
+		}
+
+	if ((event->state & (GDK_CONTROL_MASK | GDK_MOD1_MASK)) == 0)
+		{
+			c = gdk_keyval_to_unicode (event->keyval);
+			if (c >= '0' && c <= '9')
+				{
+					if (priv->editable)
+						{
+							gtk_date_field_type_digit (field, c - '0');
+						}
+					return TRUE;
+				}
+
+			/* typing a separator goes to the next segment */
+			if (c != 0
+			    && (c == (gunichar)priv->separator[0] || c == (gunichar)priv->time_separator[0] || c == ' '))
+				{
+					gtk_date_field_move_segment (field, priv->segment + 1);
+					return TRUE;
+				}
+		}
+
+	return GTK_WIDGET_CLASS (parent_class)->key_press_event (widget, event);
+}
+
+static gboolean
+gtk_date_field_button_press_event (GtkWidget *widget,
+                                   GdkEventButton *event)
+{
+	PangoLayout *layout;
+	gint x;
+	gint y;
+	gint index;
+	gint trailing;
+	guint i;
+	guint offset;
+	guint segment;
+
+	GtkDateField *field = GTK_DATE_FIELD (widget);
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (event->button != 1 || event->type != GDK_BUTTON_PRESS)
+		{
+			return FALSE;
+		}
+
+	if (!gtk_widget_has_focus (widget))
+		{
+			gtk_widget_grab_focus (widget);
+		}
+
+	/* the segment under the pointer, or the last one before it */
+	layout = gtk_date_field_get_layout (field);
+	gtk_date_field_get_text_origin (field, &x, &y);
+	pango_layout_xy_to_index (layout,
+	                          ((gint)event->x - x) * PANGO_SCALE,
+	                          ((gint)event->y - y) * PANGO_SCALE,
+	                          &index, &trailing);
+
+	segment = 0;
+	for (i = 0; gtk_date_format_get_field (priv->compiled, i, &offset, NULL) != 0; i++)
+		{
+			if (offset > (guint)index)
+				{
+					break;
+				}
+			segment = i;
+		}
+	gtk_date_field_move_segment (field, segment);
+
+	return TRUE;
+}
+
+/* compiles the date's format followed by the visible time's fields */
+static void
+gtk_date_field_compile_format (GtkDateField *field)
+{
+	gchar format[7];
+	guint n_segments;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	format[0] = '\0';
+	if (priv->date_is_visible)
+		{
+			strcpy (format, priv->format);
+		}
+	if (priv->time_is_visible)
+		{
+			strcat (format, priv->time_with_seconds ? "HMS" : "HM");
+		}
+	else
+		{
+			priv->fields[3] = -1;
+			priv->fields[4] = -1;
+			priv->fields[5] = -1;
+		}
+	if (!priv->time_with_seconds && priv->fields[5] > 0)
+		{
+			priv->fields[5] = 0;
+		}
+
+	if (priv->compiled != NULL)
+		{
+			gtk_date_format_unref (priv->compiled);
+		}
+	priv->compiled = gtk_date_format_new (format, priv->separator, priv->time_separator);
+
+	n_segments = gtk_date_format_get_n_fields (priv->compiled);
+	priv->segment = n_segments > 0 ? MIN (priv->segment, n_segments - 1) : 0;
+	priv->typed = 0;
+
+	priv->size_valid = FALSE;
+	gtk_widget_queue_resize (GTK_WIDGET (field));
+
+	gtk_date_field_update_value (field);
+}
+
+/* the shown text: the template with the segments' values, or underscores
+ * for the empty ones; the layout's text is set only if it changed */
+static void
+gtk_date_field_update_text (GtkDateField *field)
+{
+	gchar text[64];
+	gchar digits[8];
+	guint i;
+	guint offset;
+	guint width;
+	gint value;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	g_strlcpy (text, gtk_date_format_get_template (priv->compiled), sizeof (text));
+	for (i = 0; i < gtk_date_format_get_n_fields (priv->compiled); i++)
+		{
+			value = priv->fields[gtk_date_field_get_segment_field (field, i)];
+			gtk_date_format_get_field (priv->compiled, i, &offset, &width);
+			if (offset + width >= sizeof (text))
+				{
+					break;
+				}
+
+			if (value < 0)
+				{
+					memset (text + offset, '_', width);
+				}
+			else
+				{
+					g_snprintf (digits, sizeof (digits), "%0*d", width, value);
+					memcpy (text + offset, digits + strlen (digits) - width, width);
+				}
+		}
+
+	if (strcmp (text, priv->text) == 0)
+		{
+			return;
+		}
+
+	strcpy (priv->text, text);
+	if (priv->layout != NULL)
+		{
+			pango_layout_set_text (priv->layout, priv->text, -1);
+		}
+}
+
+static PangoLayout
+*gtk_date_field_get_layout (GtkDateField *field)
+{
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (priv->layout == NULL)
+		{
+			priv->layout = gtk_widget_create_pango_layout (GTK_WIDGET (field), priv->text);
+		}
+
+	return priv->layout;
+}
+
+/* where the text is drawn: after the border and the padding, centered
+ * vertically */
+static void
+gtk_date_field_get_text_origin (GtkDateField *field,
+                                gint *x,
+                                gint *y)
+{
+	GtkStyleContext *context;
+	GtkStateFlags state;
+	GtkBorder padding;
+	GtkBorder border;
+	gint text_height;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	context = gtk_widget_get_style_context (GTK_WIDGET (field));
+	state = gtk_widget_get_state_flags (GTK_WIDGET (field));
+	gtk_style_context_get_padding (context, state, &padding);
+	gtk_style_context_get_border (context, state, &border);
+
+	pango_layout_get_pixel_size (gtk_date_field_get_layout (field), NULL, &text_height);
+
+	*x = border.left + padding.left;
+	*y = (gtk_widget_get_allocated_height (GTK_WIDGET (field)) - text_height) / 2;
+}
+
+/* the index in GTK_DATE_FIELD_FIELDS of @segment's field */
+static gint
+gtk_date_field_get_segment_field (GtkDateField *field,
+                                  guint segment)
+{
+	gchar c;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	c = gtk_date_format_get_field (priv->compiled, segment, NULL, NULL);
+
+	return c != 0 ? strchr (GTK_DATE_FIELD_FIELDS, c) - GTK_DATE_FIELD_FIELDS : -1;
+}
+
+static void
+gtk_date_field_move_segment (GtkDateField *field,
+                             gint segment)
+{
+	gint n_segments;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	n_segments = gtk_date_format_get_n_fields (priv->compiled);
+	priv->segment = CLAMP (segment, 0, MAX (n_segments - 1, 0));
+	priv->typed = 0;
+
+	gtk_widget_queue_draw (GTK_WIDGET (field));
+}
+
+/* the maximum of the day's segment depends on the month and the year */
+static gint
+gtk_date_field_get_max (GtkDateField *field,
+                        gint i)
+{
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (i == 0 && priv->fields[1] > 0 && priv->fields[2] > 0)
+		{
+			return g_date_get_days_in_month (priv->fields[1], priv->fields[2]);
+		}
+
+	return field_max[i];
+}
+
+/* a digit typed in the segment; it goes to the next one when it is full,
+ * or when another digit would be too much */
+static void
+gtk_date_field_type_digit (GtkDateField *field,
+                           gint digit)
+{
+	gint i;
+	gint value;
+	guint width;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	i = gtk_date_field_get_segment_field (field, priv->segment);
+	if (i < 0)
+		{
+			return;
+		}
+	gtk_date_format_get_field (priv->compiled, priv->segment, NULL, &width);
+
+	value = priv->typed > 0 ? priv->fields[i] * 10 + digit : digit;
+	if (value > field_max[i])
+		{
+			/* it starts again from this digit */
+			value = digit;
+			priv->typed = 0;
+		}
+	priv->fields[i] = value;
+	priv->typed++;
+
+	if (priv->typed >= width || value * 10 > field_max[i])
+		{
+			if (priv->segment + 1 < gtk_date_format_get_n_fields (priv->compiled))
+				{
+					priv->segment++;
+				}
+			priv->typed = 0;
+		}
+
+	gtk_date_field_update_value (field);
+}
+
+/* Up and Down: an empty segment starts from today, or from midnight */
+static void
+gtk_date_field_step (GtkDateField *field,
+                     gint delta)
+{
+	GDateTime *now;
+	gint i;
+	gint max;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	i = gtk_date_field_get_segment_field (field, priv->segment);
+	if (i < 0)
+		{
+			return;
+		}
+
+	if (priv->fields[i] < 0)
+		{
+			if (i <= 2)
+				{
+					now = g_date_time_new_now_local ();
+					priv->fields[i] = i == 0 ? g_date_time_get_day_of_month (now)
+					                  : i == 1 ? g_date_time_get_month (now)
+					                  : g_date_time_get_year (now);
+					g_date_time_unref (now);
+				}
+			else
+				{
+					priv->fields[i] = 0;
+				}
+		}
+	else
+		{
+			max = gtk_date_field_get_max (field, i);
+			priv->fields[i] += delta;
+			if (priv->fields[i] > max)
+				{
+					priv->fields[i] = field_min[i];
+				}
+			else if (priv->fields[i] < field_min[i])
+				{
+					priv->fields[i] = max;
+				}
+		}
+	priv->typed = 0;
+
+	gtk_date_field_update_value (field);
+}
+
+static void
+gtk_date_field_clear_segment (GtkDateField *field)
+{
+	gint i;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	i = gtk_date_field_get_segment_field (field, priv->segment);
+	if (i < 0)
+		{
+			return;
+		}
+
+	priv->fields[i] = -1;
+	priv->typed = 0;
+
+	gtk_date_field_update_value (field);
+}
+
+/* the value from the segments: the date is valid only if all its segments
+ * are filled with an allowed date, the empty time's segments count as 0 */
+static void
+gtk_date_field_update_value (GtkDateField *field)
+{
+	GDate gdate;
+	GtkDateEntryValue old;
+	gint *fields;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	old = priv->value;
+	fields = priv->fields;
+
+	priv->complete = fields[0] > 0 && fields[1] > 0 && fields[2] > 0;
+	priv->value.julian = 0;
+	priv->value.valid = FALSE;
+	if (priv->complete && g_date_valid_dmy (fields[0], fields[1], fields[2]))
+		{
+			g_date_clear (&gdate, 1);
+			g_date_set_dmy (&gdate, fields[0], fields[1], fields[2]);
+			if (_gtk_date_entry_is_allowed (priv->min_julian,
+			                                priv->max_julian,
+			                                priv->rules,
+			                                g_date_get_julian (&gdate)))
+				{
+					priv->value.julian = g_date_get_julian (&gdate);
+					priv->value.valid = TRUE;
+				}
+		}
+
+	priv->value.seconds = MAX (fields[3], 0) * 3600
+	                      + MAX (fields[4], 0) * 60
+	                      + MAX (fields[5], 0);
+
+	gtk_date_field_update_text (field);
+	gtk_widget_queue_draw (GTK_WIDGET (field));
+
+	if (old.julian != priv->value.julian || old.valid != priv->value.valid)
+		{
+			g_object_notify (G_OBJECT (field), "julian");
+		}
+	if (old.seconds != priv->value.seconds)
+		{
+			g_object_notify (G_OBJECT (field), "seconds");
+		}
+
+	gtk_date_field_emit_value_changed (field);
+}
+
+/* emits "value-changed" if the value isn't the one of the last emission,
+ * unless it is frozen */
+static void
+gtk_date_field_emit_value_changed (GtkDateField *field)
+{
+	gint64 packed;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (priv->freeze_count > 0)
+		{
+			return;
+		}
+
+	packed = gtk_date_field_get_packed (field);
+	if (packed != priv->packed)
+		{
+			priv->packed = packed;
+			g_signal_emit (field, signals[VALUE_CHANGED], 0, packed);
+		}
+}
+
+/* sets the segments from a value moved inside the bounds; a julian day
+ * of 0 clears them */
+static void
+gtk_date_field_set_value_julian (GtkDateField *field,
+                                 gint32 julian,
+                                 gint32 seconds)
+{
+	GDate gdate;
+	guint i;
+
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	julian = _gtk_date_entry_clamp_julian (priv->min_julian, priv->max_julian, julian);
+	if (julian <= 0 || !g_date_valid_julian (julian))
+		{
+			for (i = 0; i < GTK_DATE_FIELD_N_FIELDS; i++)
+				{
+					priv->fields[i] = -1;
+				}
+		}
+	else
+		{
+			g_date_clear (&gdate, 1);
+			g_date_set_julian (&gdate, julian);
+			priv->fields[0] = g_date_get_day (&gdate);
+			priv->fields[1] = g_date_get_month (&gdate);
+			priv->fields[2] = g_date_get_year (&gdate);
+			if (priv->time_is_visible)
+				{
+					priv->fields[3] = seconds / 3600;
+					priv->fields[4] = (seconds / 60) % 60;
+					priv->fields[5] = priv->time_with_seconds ? seconds % 60 : 0;
+				}
+		}
+	priv->typed = 0;
+
+	gtk_date_field_update_value (field);
+}
+
+static void
+gtk_date_field_set_bounds (GtkDateField *field,
+                           guint32 min_julian,
+                           guint32 max_julian)
+{
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (priv->min_julian == min_julian
+	    && priv->max_julian == max_julian)
+		{
+			return;
+		}
+
+	g_object_freeze_notify (G_OBJECT (field));
+
+	if (priv->min_julian != min_julian)
+		{
+			priv->min_julian = min_julian;
+			g_object_notify (G_OBJECT (field), "min-date");
+		}
+	if (priv->max_julian != max_julian)
+		{
+			priv->max_julian = max_julian;
+			g_object_notify (G_OBJECT (field), "max-date");
+		}
+
+	if (priv->value.valid)
+		{
+			gtk_date_field_set_value_julian (field, priv->value.julian, priv->value.seconds);
+		}
+	else
+		{
+			gtk_date_field_update_value (field);
+		}
+
+	g_object_thaw_notify (G_OBJECT (field));
+}
+
+/* the zone given to the shared conversions: NULL in UTC mode */
+static GTimeZone
+*gtk_date_field_get_conversion_zone (GtkDateField *field)
+{
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (priv->utc)
+		{
+			return NULL;
+		}
+
+	return priv->tz != NULL ? priv->tz : _gtk_date_entry_get_local_time_zone ();
+}
+
+/* the compiled format of get_strf and set_date_strf: the @field's one for
+ * NULL, else the last one is kept */
+static GtkDateFormat
+*gtk_date_field_get_strf_format (GtkDateField *field,
+                                 const gchar *format,
+                                 const gchar *separator,
+                                 const gchar *time_separator)
+{
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (format == NULL
+	    && (separator == NULL || separator == priv->separator)
+	    && (time_separator == NULL || time_separator == priv->time_separator))
+		{
+			return priv->compiled;
+		}
+
+	if (format == NULL) format = priv->format;
+	if (separator == NULL) separator = priv->separator;
+	if (time_separator == NULL) time_separator = priv->time_separator;
+
+	if (priv->strf_format != NULL)
+		{
+			if (g_strcmp0 (gtk_date_format_get_format (priv->strf_format), format) == 0
+			    && g_strcmp0 (gtk_date_format_get_separator (priv->strf_format), separator) == 0
+			    && g_strcmp0 (gtk_date_format_get_time_separator (priv->strf_format), time_separator) == 0)
+				{
+					return priv->strf_format;
+				}
+			gtk_date_format_unref (priv->strf_format);
+		}
+
+	priv->strf_format = gtk_date_format_new (format, separator, time_separator);
+
+	return priv->strf_format;
+}
+
+/* writes the value with @fmt, only the date if the time isn't visible */
+static gsize
+gtk_date_field_write (GtkDateField *field,
+                      const GtkDateFormat *fmt,
+                      gchar *buf,
+                      gsize len)
+{
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (!priv->value.valid)
+		{
+			if (len > 0)
+				{
+					buf[0] = '\0';
+				}
+			return 0;
+		}
+
+	if (priv->time_is_visible)
+		{
+			return gtk_date_format_format (fmt, priv->value.julian, priv->value.seconds, buf, len);
+		}
+	else
+		{
+			return gtk_date_format_format_date (fmt, priv->value.julian, buf, len);
+		}
+}
+
+/* the buffer returned by get_strf and get_sql; it grows only */
+static gchar
+*gtk_date_field_get_buffer (GtkDateField *field,
+                            gsize len)
+{
+	GtkDateFieldPrivate *priv = GTK_DATE_FIELD_GET_PRIVATE (field);
+
+	if (priv->buffer_len < len)
+		{
+			priv->buffer = g_realloc (priv->buffer, len);
+			priv->buffer_len = len;
+		}
+	priv->buffer[0] = '\0';
+
+	return priv->buffer;
+}
+
+static void
+rules_on_changed (GtkDateCalendarRules *rules,
+                  gpointer user_data)
+{
+	gtk_date_field_update_value ((GtkDateField *)user_data);
+}
+
+static const gchar
+*gtk_date_field_get_value (GdaExQueryEditorIWidget *iwidget)
+{
+	return gtk_date_field_get_strf (GTK_DATE_FIELD (iwidget), gtk_date_field_is_time_visible (GTK_DATE_FIELD (iwidget)) ? "dmYHMS" : "dmY", NULL, NULL);
+}
+
+static const gchar
+*gtk_date_field_get_value_sql (GdaExQueryEditorIWidget *iwidget)
+{
+	return gtk_date_field_get_sql (GTK_DATE_FIELD (iwidget));
+}
+
+static void
+gtk_date_field_set_value (GdaExQueryEditorIWidget *iwidget,
+                          const gchar *value)
+{
+	if (value == NULL)
+		{
+			gtk_date_field_set_unix_usec (GTK_DATE_FIELD (iwidget), g_get_real_time ());
+		}
+	else
+		{
+			gtk_date_field_set_date_strf (GTK_DATE_FIELD (iwidget), value, "YmdHMS");
+		}
+}
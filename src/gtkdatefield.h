@@ -0,0 +1,148 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __GTK_DATE_FIELD_H__
+#define __GTK_DATE_FIELD_H__
+
+#include <time.h>
+
+#include <gdk/gdk.h>
+#include <gtk/gtk.h>
+
+#include "gtkdatecalendarrules.h"
+#include "gtkdateformat.h"
+
+G_BEGIN_DECLS
+
+
+#define GTK_TYPE_DATE_FIELD           (gtk_date_field_get_type ())
+#define GTK_DATE_FIELD(obj)           (G_TYPE_CHECK_INSTANCE_CAST ((obj), GTK_TYPE_DATE_FIELD, GtkDateField))
+#define GTK_DATE_FIELD_CLASS(klass)   (G_TYPE_CHECK_CLASS_CAST ((klass), GTK_TYPE_DATE_FIELD, GtkDateFieldClass))
+#define GTK_IS_DATE_FIELD(obj)        (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GTK_TYPE_DATE_FIELD))
+#define GTK_IS_DATE_FIELD_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), GTK_TYPE_DATE_FIELD))
+#define GTK_DATE_FIELD_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), GTK_TYPE_DATE_FIELD, GtkDateFieldClass))
+
+
+typedef struct _GtkDateField GtkDateField;
+typedef struct _GtkDateFieldClass GtkDateFieldClass;
+
+
+struct _GtkDateField
+{
+	GtkWidget parent;
+};
+
+struct _GtkDateFieldClass
+{
+	GtkWidgetClass parent_class;
+};
+
+
+GType gtk_date_field_get_type (void) G_GNUC_CONST;
+
+GtkWidget *gtk_date_field_new (const gchar *format,
+                               const gchar *separator);
+
+gboolean gtk_date_field_set_separator (GtkDateField *field,
+                                       const gchar *separator);
+gboolean gtk_date_field_set_time_separator (GtkDateField *field,
+                                            const gchar *separator);
+gboolean gtk_date_field_set_format (GtkDateField *field,
+                                    const gchar *format);
+
+gsize gtk_date_field_get_text_into (GtkDateField *field,
+                                    gchar *buf,
+                                    gsize len);
+gchar *gtk_date_field_dup_text (GtkDateField *field);
+
+const gchar *gtk_date_field_get_strf (GtkDateField *field,
+                                     const gchar *format,
+                                     const gchar *separator,
+                                     const gchar *time_separator);
+const gchar *gtk_date_field_get_sql (GtkDateField *field);
+struct tm *gtk_date_field_get_tm (GtkDateField *field);
+GDate *gtk_date_field_get_gdate (GtkDateField *field);
+GDateTime *gtk_date_field_get_gdatetime (GtkDateField *field);
+
+gboolean gtk_date_field_set_date_strf (GtkDateField *field,
+                                       const gchar *str,
+                                       const gchar *format);
+gboolean gtk_date_field_set_sql (GtkDateField *field,
+                                 const gchar *str);
+void gtk_date_field_set_date_tm (GtkDateField *field,
+                                 const struct tm tmdate);
+void gtk_date_field_set_date_gdate (GtkDateField *field,
+                                    const GDate *gdate);
+void gtk_date_field_set_date_gdatetime (GtkDateField *field,
+                                        const GDateTime *gdatetime);
+
+gboolean gtk_date_field_is_valid (GtkDateField *field);
+gboolean gtk_date_field_is_complete (GtkDateField *field);
+
+guint32 gtk_date_field_get_julian (GtkDateField *field);
+gint32 gtk_date_field_get_seconds (GtkDateField *field);
+void gtk_date_field_set_julian_seconds (GtkDateField *field,
+                                        guint32 julian,
+                                        gint32 seconds);
+gint64 gtk_date_field_get_packed (GtkDateField *field);
+
+void gtk_date_field_freeze_value_changed (GtkDateField *field);
+void gtk_date_field_thaw_value_changed (GtkDateField *field);
+
+gint64 gtk_date_field_get_unix_usec (GtkDateField *field);
+void gtk_date_field_set_unix_usec (GtkDateField *field,
+                                   gint64 usec);
+
+void gtk_date_field_set_timezone (GtkDateField *field,
+                                  GTimeZone *tz);
+GTimeZone *gtk_date_field_get_timezone (GtkDateField *field);
+void gtk_date_field_set_utc (GtkDateField *field,
+                             gboolean utc);
+gboolean gtk_date_field_is_utc (GtkDateField *field);
+
+void gtk_date_field_set_min_date (GtkDateField *field,
+                                  guint32 julian);
+guint32 gtk_date_field_get_min_date (GtkDateField *field);
+void gtk_date_field_set_max_date (GtkDateField *field,
+                                  guint32 julian);
+guint32 gtk_date_field_get_max_date (GtkDateField *field);
+
+void gtk_date_field_set_calendar_rules (GtkDateField *field,
+                                        GtkDateCalendarRules *rules);
+GtkDateCalendarRules *gtk_date_field_get_calendar_rules (GtkDateField *field);
+gboolean gtk_date_field_next_business_day (GtkDateField *field);
+
+void gtk_date_field_set_editable (GtkDateField *field,
+                                  gboolean is_editable);
+gboolean gtk_date_field_is_editable (GtkDateField *field);
+
+void gtk_date_field_set_date_visible (GtkDateField *field,
+                                      gboolean is_visible);
+gboolean gtk_date_field_is_date_visible (GtkDateField *field);
+
+void gtk_date_field_set_time_visible (GtkDateField *field,
+                                      gboolean is_visible);
+gboolean gtk_date_field_is_time_visible (GtkDateField *field);
+
+
+G_END_DECLS
+
+#endif /* __GTK_DATE_FIELD_H__ */
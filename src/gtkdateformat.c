@@ -0,0 +1,1039 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+	#include <config.h>
+#endif
+
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "gtkdateformat.h"
+
+/* GDate's julian day of 1970-01-01 */
+#define GTK_DATE_FORMAT_JULIAN_1970 719163
+
+typedef enum
+	{
+		GTK_DATE_FORMAT_FIELD_DAY,
+		GTK_DATE_FORMAT_FIELD_MONTH,
+		GTK_DATE_FORMAT_FIELD_YEAR,
+		GTK_DATE_FORMAT_FIELD_HOUR,
+		GTK_DATE_FORMAT_FIELD_MINUTE,
+		GTK_DATE_FORMAT_FIELD_SECOND,
+		GTK_DATE_FORMAT_N_FIELDS
+	} GtkDateFormatField;
+
+typedef struct
+	{
+		guint8 field;
+		guint8 width;
+		guint16 parse_offset;   /* position in a string to parse */
+		guint16 print_offset;   /* position in a formatted string */
+	} GtkDateFormatOp;
+
+struct _GtkDateFormat
+	{
+		gint ref_count;
+
+		const gchar *format;
+		const gchar *separator;
+		const gchar *time_separator;
+
+		GtkDateFormatOp *ops;
+		guint n_ops;
+
+		gboolean has_date;
+		gboolean has_time;
+
+		/* TRUE if the fields are Y m d H M S at their usual positions
+		 * (YYYY-MM-DD HH:MM:SS), that has a vectorized parser */
+		gboolean iso_layout;
+
+		/* the formatted text with zeroes in place of the digits;
+		 * its date part is the mask */
+		gchar *template;
+		gchar *mask;
+		gsize width;
+		gsize date_width;
+	};
+
+static const gchar digits2[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+G_DEFINE_BOXED_TYPE (GtkDateFormat, gtk_date_format, gtk_date_format_ref, gtk_date_format_unref)
+
+/**
+ * gtk_date_format_new:
+ * @format: a #gchar which is the date's format.
+ * Possible values are:
+ * - d: day of the month with leading zeroes
+ * - m: month of the year with leading zeroes
+ * - Y: year with century
+ * - H: hours with leading zeroes
+ * - M: minutes with leading zeroes
+ * - S: seconds with leading zeroes.
+ * Other characters are ignored.
+ * @separator: the string between day, month and year, of any length, also
+ * empty; if NULL, "/" is used.
+ * @time_separator: the string between hours, minutes and seconds, of any
+ * length, also empty; if NULL, ":" is used.
+ *
+ * Compiles @format in a #GtkDateFormat, that can be used many times to parse
+ * and to format dates without inspecting @format again. A string to parse
+ * has the fields in @format's order, @separator between two date's fields,
+ * @time_separator between two time's fields and one character between a
+ * date's and a time's field: what gtk_date_format_format() writes, when
+ * @format has the date's fields first.
+ *
+ * Returns: a new #GtkDateFormat; free it with gtk_date_format_unref().
+ */
+GtkDateFormat
+*gtk_date_format_new (const gchar *format,
+                      const gchar *separator,
+                      const gchar *time_separator)
+{
+	GtkDateFormat *fmt;
+	GtkDateFormatOp *op;
+
+	guint i;
+	guint l;
+	guint parse_offset;
+	guint print_offset;
+	gsize sep_len;
+	gsize tsep_len;
+	gboolean first;
+
+	g_return_val_if_fail (format != NULL, NULL);
+
+	fmt = g_new0 (GtkDateFormat, 1);
+	fmt->ref_count = 1;
+
+	fmt->format = g_intern_string (format);
+	fmt->separator = g_intern_string (separator != NULL ? separator : "/");
+	fmt->time_separator = g_intern_string (time_separator != NULL ? time_separator : ":");
+
+	sep_len = strlen (fmt->separator);
+	tsep_len = strlen (fmt->time_separator);
+
+	l = strlen (format);
+	fmt->ops = g_new0 (GtkDateFormatOp, l > 0 ? l : 1);
+
+	/* in a string to parse a field is followed by the separator's length,
+	 * the time separator's one or the space's one between date and time */
+	parse_offset = 0;
+	for (i = 0; i < l; i++)
+		{
+			op = &fmt->ops[fmt->n_ops];
+			switch (format[i])
+				{
+					case 'd':
+						op->field = GTK_DATE_FORMAT_FIELD_DAY;
+						op->width = 2;
+						fmt->has_date = TRUE;
+						break;
+
+					case 'm':
+						op->field = GTK_DATE_FORMAT_FIELD_MONTH;
+						op->width = 2;
+						fmt->has_date = TRUE;
+						break;
+
+					case 'Y':
+						op->field = GTK_DATE_FORMAT_FIELD_YEAR;
+						op->width = 4;
+						fmt->has_date = TRUE;
+						break;
+
+					case 'H':
+						op->field = GTK_DATE_FORMAT_FIELD_HOUR;
+						op->width = 2;
+						fmt->has_time = TRUE;
+						break;
+
+					case 'M':
+						op->field = GTK_DATE_FORMAT_FIELD_MINUTE;
+						op->width = 2;
+						fmt->has_time = TRUE;
+						break;
+
+					case 'S':
+						op->field = GTK_DATE_FORMAT_FIELD_SECOND;
+						op->width = 2;
+						fmt->has_time = TRUE;
+						break;
+
+					default:
+						continue;
+				}
+
+			if (fmt->n_ops > 0)
+				{
+					if ((op - 1)->field <= GTK_DATE_FORMAT_FIELD_YEAR
+					    && op->field <= GTK_DATE_FORMAT_FIELD_YEAR)
+						{
+							parse_offset += sep_len;
+						}
+					else if ((op - 1)->field > GTK_DATE_FORMAT_FIELD_YEAR
+					         && op->field > GTK_DATE_FORMAT_FIELD_YEAR)
+						{
+							parse_offset += tsep_len;
+						}
+					else
+						{
+							parse_offset++;
+						}
+				}
+			op->parse_offset = parse_offset;
+			parse_offset += op->width;
+			fmt->n_ops++;
+		}
+
+	fmt->iso_layout = fmt->n_ops == 6
+	                  && sep_len == 1
+	                  && tsep_len == 1
+	                  && fmt->ops[0].field == GTK_DATE_FORMAT_FIELD_YEAR
+	                  && fmt->ops[1].field == GTK_DATE_FORMAT_FIELD_MONTH
+	                  && fmt->ops[2].field == GTK_DATE_FORMAT_FIELD_DAY
+	                  && fmt->ops[3].field == GTK_DATE_FORMAT_FIELD_HOUR
+	                  && fmt->ops[4].field == GTK_DATE_FORMAT_FIELD_MINUTE
+	                  && fmt->ops[5].field == GTK_DATE_FORMAT_FIELD_SECOND;
+
+	/* a formatted string has the date part first, then a space and the time part */
+	print_offset = 0;
+	first = TRUE;
+	for (i = 0; i < fmt->n_ops; i++)
+		{
+			op = &fmt->ops[i];
+			if (op->field > GTK_DATE_FORMAT_FIELD_YEAR) continue;
+
+			if (!first) print_offset += sep_len;
+			op->print_offset = print_offset;
+			print_offset += op->width;
+			first = FALSE;
+		}
+	fmt->date_width = print_offset;
+
+	if (fmt->has_date && fmt->has_time)
+		{
+			print_offset++;
+		}
+	first = TRUE;
+	for (i = 0; i < fmt->n_ops; i++)
+		{
+			op = &fmt->ops[i];
+			if (op->field <= GTK_DATE_FORMAT_FIELD_YEAR) continue;
+
+			if (!first) print_offset += tsep_len;
+			op->print_offset = print_offset;
+			print_offset += op->width;
+			first = FALSE;
+		}
+	fmt->width = print_offset;
+
+	fmt->template = g_malloc (fmt->width + 1);
+	memset (fmt->template, ' ', fmt->width);
+	fmt->template[fmt->width] = '\0';
+
+	first = TRUE;
+	for (i = 0; i < fmt->n_ops; i++)
+		{
+			op = &fmt->ops[i];
+			if (op->field > GTK_DATE_FORMAT_FIELD_YEAR) continue;
+
+			if (!first) memcpy (fmt->template + op->print_offset - sep_len, fmt->separator, sep_len);
+			memset (fmt->template + op->print_offset, '0', op->width);
+			first = FALSE;
+		}
+	first = TRUE;
+	for (i = 0; i < fmt->n_ops; i++)
+		{
+			op = &fmt->ops[i];
+			if (op->field <= GTK_DATE_FORMAT_FIELD_YEAR) continue;
+
+			if (!first) memcpy (fmt->template + op->print_offset - tsep_len, fmt->time_separator, tsep_len);
+			memset (fmt->template + op->print_offset, '0', op->width);
+			first = FALSE;
+		}
+
+	fmt->mask = g_strndup (fmt->template, fmt->date_width);
+
+	return fmt;
+}
+
+/**
+ * gtk_date_format_ref:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Returns: @fmt with its reference count increased by one.
+ */
+GtkDateFormat
+*gtk_date_format_ref (GtkDateFormat *fmt)
+{
+	g_return_val_if_fail (fmt != NULL, NULL);
+
+	g_atomic_int_inc (&fmt->ref_count);
+
+	return fmt;
+}
+
+/**
+ * gtk_date_format_unref:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Decreases the reference count of @fmt, freeing it when it reaches zero.
+ */
+void
+gtk_date_format_unref (GtkDateFormat *fmt)
+{
+	g_return_if_fail (fmt != NULL);
+
+	if (g_atomic_int_dec_and_test (&fmt->ref_count))
+		{
+			g_free (fmt->ops);
+			g_free (fmt->template);
+			g_free (fmt->mask);
+			g_free (fmt);
+		}
+}
+
+/**
+ * gtk_date_format_get_format:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Returns: the format string @fmt was compiled from.
+ */
+const gchar
+*gtk_date_format_get_format (const GtkDateFormat *fmt)
+{
+	g_return_val_if_fail (fmt != NULL, NULL);
+
+	return fmt->format;
+}
+
+/**
+ * gtk_date_format_get_separator:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Returns: the separator between day, month and year.
+ */
+const gchar
+*gtk_date_format_get_separator (const GtkDateFormat *fmt)
+{
+	g_return_val_if_fail (fmt != NULL, NULL);
+
+	return fmt->separator;
+}
+
+/**
+ * gtk_date_format_get_time_separator:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Returns: the separator between hours, minutes and seconds.
+ */
+const gchar
+*gtk_date_format_get_time_separator (const GtkDateFormat *fmt)
+{
+	g_return_val_if_fail (fmt != NULL, NULL);
+
+	return fmt->time_separator;
+}
+
+/**
+ * gtk_date_format_has_date:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Returns: TRUE if @fmt has at least one of the date's fields.
+ */
+gboolean
+gtk_date_format_has_date (const GtkDateFormat *fmt)
+{
+	g_return_val_if_fail (fmt != NULL, FALSE);
+
+	return fmt->has_date;
+}
+
+/**
+ * gtk_date_format_has_time:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Returns: TRUE if @fmt has at least one of the time's fields.
+ */
+gboolean
+gtk_date_format_has_time (const GtkDateFormat *fmt)
+{
+	g_return_val_if_fail (fmt != NULL, FALSE);
+
+	return fmt->has_time;
+}
+
+/**
+ * gtk_date_format_get_width:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Returns: the length of a string formatted with @fmt, without the
+ * terminating nul.
+ */
+gsize
+gtk_date_format_get_width (const GtkDateFormat *fmt)
+{
+	g_return_val_if_fail (fmt != NULL, 0);
+
+	return fmt->width;
+}
+
+/**
+ * gtk_date_format_get_mask:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Returns: the date part of @fmt as a #GtkMaskedEntry's mask.
+ */
+const gchar
+*gtk_date_format_get_mask (const GtkDateFormat *fmt)
+{
+	g_return_val_if_fail (fmt != NULL, NULL);
+
+	return fmt->mask;
+}
+
+/**
+ * gtk_date_format_get_template:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Returns: a string formatted with @fmt, with zeroes in place of the
+ * digits.
+ */
+const gchar
+*gtk_date_format_get_template (const GtkDateFormat *fmt)
+{
+	g_return_val_if_fail (fmt != NULL, NULL);
+
+	return fmt->template;
+}
+
+/**
+ * gtk_date_format_get_n_fields:
+ * @fmt: a #GtkDateFormat.
+ *
+ * Returns: the number of fields of @fmt.
+ */
+guint
+gtk_date_format_get_n_fields (const GtkDateFormat *fmt)
+{
+	g_return_val_if_fail (fmt != NULL, 0);
+
+	return fmt->n_ops;
+}
+
+/**
+ * gtk_date_format_get_field:
+ * @fmt: a #GtkDateFormat.
+ * @i: the field's index, in the order of the format's string.
+ * @offset: (out) (allow-none): the field's position in a string formatted
+ * with @fmt.
+ * @width: (out) (allow-none): the field's number of digits.
+ *
+ * Returns: the field's char in the format (d, m, Y, H, M or S); 0 if @i
+ * is out of range.
+ */
+gchar
+gtk_date_format_get_field (const GtkDateFormat *fmt,
+                           guint i,
+                           guint *offset,
+                           guint *width)
+{
+	static const gchar chars[GTK_DATE_FORMAT_N_FIELDS] = { 'd', 'm', 'Y', 'H', 'M', 'S' };
+
+	g_return_val_if_fail (fmt != NULL, 0);
+
+	if (i >= fmt->n_ops)
+		{
+			return 0;
+		}
+
+	if (offset != NULL)
+		{
+			*offset = fmt->ops[i].print_offset;
+		}
+	if (width != NULL)
+		{
+			*width = fmt->ops[i].width;
+		}
+
+	return chars[fmt->ops[i].field];
+}
+
+/* PRIVATE */
+static inline gint
+gtk_date_format_days_in_month (gint month, gint year)
+{
+	static const gint8 days[13] = { 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+	if (month == 2
+	    && (year % 4) == 0
+	    && ((year % 100) != 0 || (year % 400) == 0))
+		{
+			return 29;
+		}
+
+	return days[month];
+}
+
+/* same numbering of g_date_get_julian (): 1 is the first of January of year 1 */
+static inline gint32
+gtk_date_format_julian_from_dmy (gint day, gint month, gint year)
+{
+	gint32 era;
+	gint32 yoe;
+	gint32 doy;
+	gint32 doe;
+
+	year -= month <= 2;
+	era = year / 400;
+	yoe = year - era * 400;
+	doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+	doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+	return era * 146097 + doe - 719468 + GTK_DATE_FORMAT_JULIAN_1970;
+}
+
+static inline void
+gtk_date_format_dmy_from_julian (gint32 julian, gint *day, gint *month, gint *year)
+{
+	gint32 z;
+	gint32 era;
+	guint32 doe;
+	guint32 yoe;
+	guint32 doy;
+	guint32 mp;
+
+	z = julian - GTK_DATE_FORMAT_JULIAN_1970 + 719468;
+	era = z / 146097;
+	doe = (guint32)(z - era * 146097);
+	yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	mp = (5 * doy + 2) / 153;
+
+	*day = (gint)(doy - (153 * mp + 2) / 5 + 1);
+	*month = (gint)(mp < 10 ? mp + 3 : mp - 9);
+	*year = (gint)yoe + era * 400 + (*month <= 2);
+}
+
+static inline gint
+gtk_date_format_read_digits (const gchar *str, guint width)
+{
+	guint i;
+	gint val;
+
+	val = 0;
+	for (i = 0; i < width; i++)
+		{
+			if (str[i] < '0' || str[i] > '9')
+				{
+					return -1;
+				}
+			val = val * 10 + (str[i] - '0');
+		}
+
+	return val;
+}
+
+/* validates the parsed fields and packs them into a julian day and seconds */
+static inline gboolean
+gtk_date_format_pack_fields (const gint *fields,
+                             gint32 *julian,
+                             gint32 *seconds)
+{
+	if (fields[GTK_DATE_FORMAT_FIELD_YEAR] < 1
+	    || fields[GTK_DATE_FORMAT_FIELD_MONTH] < 1
+	    || fields[GTK_DATE_FORMAT_FIELD_MONTH] > 12
+	    || fields[GTK_DATE_FORMAT_FIELD_DAY] < 1
+	    || fields[GTK_DATE_FORMAT_FIELD_DAY] > gtk_date_format_days_in_month (fields[GTK_DATE_FORMAT_FIELD_MONTH],
+	                                                                          fields[GTK_DATE_FORMAT_FIELD_YEAR])
+	    || fields[GTK_DATE_FORMAT_FIELD_HOUR] > 23
+	    || fields[GTK_DATE_FORMAT_FIELD_MINUTE] > 59
+	    || fields[GTK_DATE_FORMAT_FIELD_SECOND] > 59)
+		{
+			*julian = 0;
+			*seconds = 0;
+			return FALSE;
+		}
+
+	*julian = gtk_date_format_julian_from_dmy (fields[GTK_DATE_FORMAT_FIELD_DAY],
+	                                           fields[GTK_DATE_FORMAT_FIELD_MONTH],
+	                                           fields[GTK_DATE_FORMAT_FIELD_YEAR]);
+	*seconds = fields[GTK_DATE_FORMAT_FIELD_HOUR] * 3600
+	           + fields[GTK_DATE_FORMAT_FIELD_MINUTE] * 60
+	           + fields[GTK_DATE_FORMAT_FIELD_SECOND];
+
+	return TRUE;
+}
+
+/* the scalar parser behind gtk_date_format_parse () */
+static inline gboolean
+gtk_date_format_parse_fields (const GtkDateFormat *fmt,
+                              const gchar *str,
+                              gint *fields)
+{
+	const GtkDateFormatOp *op;
+	const gchar *p;
+	const gchar *next;
+	gint val;
+	guint i;
+
+	for (i = 0; i < fmt->n_ops; i++)
+		{
+			op = &fmt->ops[i];
+			p = str + op->parse_offset;
+			if (*p == '\0')
+				{
+					break;
+				}
+
+			val = gtk_date_format_read_digits (p, op->width);
+			if (val < 0)
+				{
+					return FALSE;
+				}
+			fields[op->field] = val;
+
+			if (i + 1 == fmt->n_ops)
+				{
+					break;
+				}
+
+			/* a shorter string ends in the separator: the next field isn't
+			 * read past its end */
+			next = str + fmt->ops[i + 1].parse_offset;
+			for (p += op->width; p < next; p++)
+				{
+					if (*p == '\0')
+						{
+							return TRUE;
+						}
+				}
+		}
+
+	return TRUE;
+}
+
+#ifdef __SSE2__
+/*
+ * reads a complete YYYY-MM-DD HH:MM:SS with one 16 bytes load;
+ * returns FALSE if @str doesn't have that shape (also if it is shorter),
+ * and then the scalar parser must be used
+ */
+static inline gboolean
+gtk_date_format_parse_iso_sse2 (const gchar *str,
+                                gint *fields)
+{
+	/* digits' positions in the first 16 bytes */
+	const gint digits_mask = 0xdb6f;
+
+	__m128i zero;
+	__m128i v;
+	__m128i d;
+	__m128i w;
+	__m128i s;
+	gint32 p[8];
+	gint32 q[8];
+
+	/* the load mustn't go past the end of @str */
+	if (strnlen (str, 19) < 19)
+		{
+			return FALSE;
+		}
+
+	zero = _mm_setzero_si128 ();
+	v = _mm_loadu_si128 ((const __m128i *)str);
+
+	/* every digit's byte must be in 0..9 after subtracting '0' */
+	d = _mm_sub_epi8 (v, _mm_set1_epi8 ('0'));
+	if ((_mm_movemask_epi8 (_mm_cmpeq_epi8 (_mm_min_epu8 (d, _mm_set1_epi8 (9)), d)) & digits_mask) != digits_mask
+	    || str[17] < '0' || str[17] > '9'
+	    || str[18] < '0' || str[18] > '9')
+		{
+			return FALSE;
+		}
+
+	/* pairs of digits as 10 * a + b, at even positions (p)
+	 * and, shifting by one byte, at odd positions (q) */
+	w = _mm_set1_epi32 (0x0001000a);
+	_mm_storeu_si128 ((__m128i *)p, _mm_madd_epi16 (_mm_unpacklo_epi8 (d, zero), w));
+	_mm_storeu_si128 ((__m128i *)(p + 4), _mm_madd_epi16 (_mm_unpackhi_epi8 (d, zero), w));
+	s = _mm_srli_si128 (d, 1);
+	_mm_storeu_si128 ((__m128i *)q, _mm_madd_epi16 (_mm_unpacklo_epi8 (s, zero), w));
+	_mm_storeu_si128 ((__m128i *)(q + 4), _mm_madd_epi16 (_mm_unpackhi_epi8 (s, zero), w));
+
+	fields[GTK_DATE_FORMAT_FIELD_YEAR] = p[0] * 100 + p[1];   /* 0-3 */
+	fields[GTK_DATE_FORMAT_FIELD_MONTH] = q[2];               /* 5-6 */
+	fields[GTK_DATE_FORMAT_FIELD_DAY] = p[4];                 /* 8-9 */
+	fields[GTK_DATE_FORMAT_FIELD_HOUR] = q[5];                /* 11-12 */
+	fields[GTK_DATE_FORMAT_FIELD_MINUTE] = p[7];              /* 14-15 */
+	fields[GTK_DATE_FORMAT_FIELD_SECOND] = (str[17] - '0') * 10 + (str[18] - '0');
+
+	return TRUE;
+}
+#endif
+
+static inline void
+gtk_date_format_write_digits (gchar *buf, guint width, gint val)
+{
+	if (width == 4)
+		{
+			memcpy (buf, digits2 + (val / 100) * 2, 2);
+			buf += 2;
+			val %= 100;
+		}
+	memcpy (buf, digits2 + val * 2, 2);
+}
+
+/* @buf must have room for the template and the terminating nul */
+static inline void
+gtk_date_format_write_fields (const GtkDateFormat *fmt,
+                              const gint *fields,
+                              gboolean with_time,
+                              gchar *buf)
+{
+	gsize width;
+	guint i;
+
+	width = with_time ? fmt->width : fmt->date_width;
+
+	memcpy (buf, fmt->template, width);
+	buf[width] = '\0';
+	for (i = 0; i < fmt->n_ops; i++)
+		{
+			if (!with_time && fmt->ops[i].field > GTK_DATE_FORMAT_FIELD_YEAR) continue;
+
+			gtk_date_format_write_digits (buf + fmt->ops[i].print_offset,
+			                              fmt->ops[i].width,
+			                              fields[fmt->ops[i].field]);
+		}
+}
+
+static gsize
+gtk_date_format_write (const GtkDateFormat *fmt,
+                       gint32 julian,
+                       gint32 seconds,
+                       gboolean with_time,
+                       gchar *buf,
+                       gsize len)
+{
+	gint fields[GTK_DATE_FORMAT_N_FIELDS];
+	gsize width;
+
+	if (len > 0)
+		{
+			buf[0] = '\0';
+		}
+
+	if (julian < 1 || seconds < 0 || seconds >= 86400)
+		{
+			return 0;
+		}
+
+	gtk_date_format_dmy_from_julian (julian,
+	                                 &fields[GTK_DATE_FORMAT_FIELD_DAY],
+	                                 &fields[GTK_DATE_FORMAT_FIELD_MONTH],
+	                                 &fields[GTK_DATE_FORMAT_FIELD_YEAR]);
+	if (fields[GTK_DATE_FORMAT_FIELD_YEAR] > 9999)
+		{
+			return 0;
+		}
+	fields[GTK_DATE_FORMAT_FIELD_HOUR] = seconds / 3600;
+	fields[GTK_DATE_FORMAT_FIELD_MINUTE] = (seconds / 60) % 60;
+	fields[GTK_DATE_FORMAT_FIELD_SECOND] = seconds % 60;
+
+	width = with_time ? fmt->width : fmt->date_width;
+	if (len < width + 1)
+		{
+			return width;
+		}
+
+	gtk_date_format_write_fields (fmt, fields, with_time, buf);
+
+	return width;
+}
+
+/**
+ * gtk_date_format_parse:
+ * @fmt: a #GtkDateFormat.
+ * @str: the string to parse.
+ * @julian: (out): the date as a GDate's julian day.
+ * @seconds: (out): the seconds of the day.
+ *
+ * Parses @str with the same rules of gtk_date_entry_set_date_strf(): every
+ * field has a fixed width and it is followed by one separator's char; if @str
+ * ends before all the fields are read, the missing time's fields are zero.
+ * It doesn't allocate memory.
+ *
+ * Returns: TRUE if @str is a valid date; otherwise @julian and @seconds are
+ * set to zero.
+ */
+gboolean
+gtk_date_format_parse (const GtkDateFormat *fmt,
+                       const gchar *str,
+                       gint32 *julian,
+                       gint32 *seconds)
+{
+	gint fields[GTK_DATE_FORMAT_N_FIELDS] = { 0 };
+
+	g_return_val_if_fail (fmt != NULL, FALSE);
+	g_return_val_if_fail (julian != NULL, FALSE);
+	g_return_val_if_fail (seconds != NULL, FALSE);
+
+	*julian = 0;
+	*seconds = 0;
+
+	if (str == NULL
+	    || !gtk_date_format_parse_fields (fmt, str, fields))
+		{
+			return FALSE;
+		}
+
+	return gtk_date_format_pack_fields (fields, julian, seconds);
+}
+
+/**
+ * gtk_date_format_parse_many:
+ * @fmt: a #GtkDateFormat.
+ * @strs: (array length=n): the strings to parse.
+ * @n: the number of strings in @strs.
+ * @julian: (out caller-allocates) (array length=n): where to write the dates,
+ * as GDate's julian days.
+ * @seconds: (out caller-allocates) (array length=n): where to write the
+ * seconds of the day.
+ * @valid: (out caller-allocates) (array length=n) (allow-none): where to
+ * write if every string is a valid date.
+ *
+ * Parses @n strings with the same rules of gtk_date_format_parse(), writing
+ * the results into the arrays given by the caller; invalid dates (and NULL
+ * strings) have zero @julian and @seconds. Strings shaped as
+ * YYYY-MM-DD HH:MM:SS, with a Y m d H M S @fmt, take a vectorized path where
+ * the CPU supports it. It doesn't allocate memory.
+ *
+ * Returns: the number of valid dates.
+ */
+gsize
+gtk_date_format_parse_many (const GtkDateFormat *fmt,
+                            const gchar * const *strs,
+                            gsize n,
+                            gint32 *julian,
+                            gint32 *seconds,
+                            guint8 *valid)
+{
+	gint fields[GTK_DATE_FORMAT_N_FIELDS];
+	gboolean ok;
+	gsize ret;
+	gsize i;
+
+	g_return_val_if_fail (fmt != NULL, 0);
+	g_return_val_if_fail (strs != NULL || n == 0, 0);
+	g_return_val_if_fail (julian != NULL || n == 0, 0);
+	g_return_val_if_fail (seconds != NULL || n == 0, 0);
+
+	ret = 0;
+	for (i = 0; i < n; i++)
+		{
+			memset (fields, 0, sizeof (fields));
+
+			if (strs[i] == NULL)
+				{
+					ok = FALSE;
+				}
+#ifdef __SSE2__
+			else if (fmt->iso_layout
+			         && gtk_date_format_parse_iso_sse2 (strs[i], fields))
+				{
+					ok = TRUE;
+				}
+#endif
+			else
+				{
+					ok = gtk_date_format_parse_fields (fmt, strs[i], fields);
+				}
+
+			if (ok)
+				{
+					ok = gtk_date_format_pack_fields (fields, &julian[i], &seconds[i]);
+				}
+			else
+				{
+					julian[i] = 0;
+					seconds[i] = 0;
+				}
+
+			if (valid != NULL)
+				{
+					valid[i] = ok;
+				}
+			ret += ok;
+		}
+
+	return ret;
+}
+
+/**
+ * gtk_date_format_format:
+ * @fmt: a #GtkDateFormat.
+ * @julian: the date as a GDate's julian day.
+ * @seconds: the seconds of the day.
+ * @buf: the buffer to write into.
+ * @len: the size of @buf.
+ *
+ * Formats @julian and @seconds into @buf with the same rules of
+ * gtk_date_entry_get_strf(). It doesn't allocate memory.
+ *
+ * Returns: the length of the formatted string, without the terminating nul;
+ * 0 if @julian isn't a valid date. If it isn't less than @len, @buf isn't
+ * big enough and it is left empty.
+ */
+gsize
+gtk_date_format_format (const GtkDateFormat *fmt,
+                        gint32 julian,
+                        gint32 seconds,
+                        gchar *buf,
+                        gsize len)
+{
+	g_return_val_if_fail (fmt != NULL, 0);
+	g_return_val_if_fail (buf != NULL || len == 0, 0);
+
+	return gtk_date_format_write (fmt, julian, seconds, TRUE, buf, len);
+}
+
+/**
+ * gtk_date_format_format_date:
+ * @fmt: a #GtkDateFormat.
+ * @julian: the date as a GDate's julian day.
+ * @buf: the buffer to write into.
+ * @len: the size of @buf.
+ *
+ * Like gtk_date_format_format(), but it writes only the date part.
+ *
+ * Returns: the length of the formatted string, without the terminating nul.
+ */
+gsize
+gtk_date_format_format_date (const GtkDateFormat *fmt,
+                             gint32 julian,
+                             gchar *buf,
+                             gsize len)
+{
+	g_return_val_if_fail (fmt != NULL, 0);
+	g_return_val_if_fail (buf != NULL || len == 0, 0);
+
+	return gtk_date_format_write (fmt, julian, 0, FALSE, buf, len);
+}
+
+/**
+ * gtk_date_format_format_many:
+ * @fmt: a #GtkDateFormat.
+ * @julian: (array length=n): the dates as GDate's julian days.
+ * @seconds: (array length=n) (allow-none): the seconds of the day; if NULL
+ * only the date part is written.
+ * @n: the number of values.
+ * @buf: the buffer to write into, at least @n * @stride bytes long.
+ * @stride: the distance in bytes between two strings in @buf; it must be
+ * greater than gtk_date_format_get_width().
+ *
+ * Formats @n values with the same rules of gtk_date_format_format(): the
+ * i-th string is written nul terminated at @buf + i * @stride, and it is
+ * left empty if the value isn't a valid date. It doesn't allocate memory.
+ *
+ * Returns: the number of valid dates.
+ */
+gsize
+gtk_date_format_format_many (const GtkDateFormat *fmt,
+                             const gint32 *julian,
+                             const gint32 *seconds,
+                             gsize n,
+                             gchar *buf,
+                             gsize stride)
+{
+	gint fields[GTK_DATE_FORMAT_N_FIELDS];
+	gint32 last_julian;
+	gboolean with_time;
+	gint32 s;
+	gsize ret;
+	gsize i;
+
+	g_return_val_if_fail (fmt != NULL, 0);
+	g_return_val_if_fail (julian != NULL || n == 0, 0);
+	g_return_val_if_fail (buf != NULL || n == 0, 0);
+	g_return_val_if_fail (stride > fmt->width || n == 0, 0);
+
+	with_time = seconds != NULL;
+	fields[GTK_DATE_FORMAT_FIELD_HOUR] = 0;
+	fields[GTK_DATE_FORMAT_FIELD_MINUTE] = 0;
+	fields[GTK_DATE_FORMAT_FIELD_SECOND] = 0;
+
+	/* rows of a report often share the date, so the last one is kept */
+	last_julian = 0;
+
+	ret = 0;
+	for (i = 0; i < n; i++, buf += stride)
+		{
+			s = with_time ? seconds[i] : 0;
+			if (julian[i] < 1 || s < 0 || s >= 86400)
+				{
+					buf[0] = '\0';
+					continue;
+				}
+
+			if (julian[i] != last_julian)
+				{
+					gtk_date_format_dmy_from_julian (julian[i],
+					                                 &fields[GTK_DATE_FORMAT_FIELD_DAY],
+					                                 &fields[GTK_DATE_FORMAT_FIELD_MONTH],
+					                                 &fields[GTK_DATE_FORMAT_FIELD_YEAR]);
+					last_julian = julian[i];
+				}
+			if (fields[GTK_DATE_FORMAT_FIELD_YEAR] > 9999)
+				{
+					buf[0] = '\0';
+					continue;
+				}
+
+			if (with_time)
+				{
+					fields[GTK_DATE_FORMAT_FIELD_HOUR] = s / 3600;
+					fields[GTK_DATE_FORMAT_FIELD_MINUTE] = (s / 60) % 60;
+					fields[GTK_DATE_FORMAT_FIELD_SECOND] = s % 60;
+				}
+
+			gtk_date_format_write_fields (fmt, fields, with_time, buf);
+			ret++;
+		}
+
+	return ret;
+}
@@ -0,0 +1,97 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __GTK_DATE_FORMAT_H__
+#define __GTK_DATE_FORMAT_H__
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+
+#define GTK_TYPE_DATE_FORMAT          (gtk_date_format_get_type ())
+
+
+typedef struct _GtkDateFormat GtkDateFormat;
+
+
+GType gtk_date_format_get_type (void) G_GNUC_CONST;
+
+/* @separator and @time_separator are strings of any length, also empty;
+ * gtk_date_format_parse() reads back what gtk_date_format_format() writes,
+ * with the date's fields first in @format */
+GtkDateFormat *gtk_date_format_new (const gchar *format,
+                                    const gchar *separator,
+                                    const gchar *time_separator);
+
+GtkDateFormat *gtk_date_format_ref (GtkDateFormat *fmt);
+void gtk_date_format_unref (GtkDateFormat *fmt);
+
+const gchar *gtk_date_format_get_format (const GtkDateFormat *fmt);
+const gchar *gtk_date_format_get_separator (const GtkDateFormat *fmt);
+const gchar *gtk_date_format_get_time_separator (const GtkDateFormat *fmt);
+
+gboolean gtk_date_format_has_date (const GtkDateFormat *fmt);
+gboolean gtk_date_format_has_time (const GtkDateFormat *fmt);
+
+gsize gtk_date_format_get_width (const GtkDateFormat *fmt);
+const gchar *gtk_date_format_get_mask (const GtkDateFormat *fmt);
+const gchar *gtk_date_format_get_template (const GtkDateFormat *fmt);
+
+guint gtk_date_format_get_n_fields (const GtkDateFormat *fmt);
+gchar gtk_date_format_get_field (const GtkDateFormat *fmt,
+                                 guint i,
+                                 guint *offset,
+                                 guint *width);
+
+gboolean gtk_date_format_parse (const GtkDateFormat *fmt,
+                                const gchar *str,
+                                gint32 *julian,
+                                gint32 *seconds);
+
+gsize gtk_date_format_parse_many (const GtkDateFormat *fmt,
+                                  const gchar * const *strs,
+                                  gsize n,
+                                  gint32 *julian,
+                                  gint32 *seconds,
+                                  guint8 *valid);
+
+gsize gtk_date_format_format (const GtkDateFormat *fmt,
+                              gint32 julian,
+                              gint32 seconds,
+                              gchar *buf,
+                              gsize len);
+gsize gtk_date_format_format_date (const GtkDateFormat *fmt,
+                                   gint32 julian,
+                                   gchar *buf,
+                                   gsize len);
+
+gsize gtk_date_format_format_many (const GtkDateFormat *fmt,
+                                   const gint32 *julian,
+                                   const gint32 *seconds,
+                                   gsize n,
+                                   gchar *buf,
+                                   gsize stride);
+
+
+G_END_DECLS
+
+#endif /* __GTK_DATE_FORMAT_H__ */
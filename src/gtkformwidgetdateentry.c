@@ -16,6 +16,10 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#ifdef HAVE_CONFIG_H
+	#include <config.h>
+#endif
+
 #include <gtk/gtk.h>
 
 #include "gtkdateentry.h"
@@ -43,7 +47,8 @@ static void gtk_form_widget_date_entry_get_property (GObject *object,
 typedef struct _GtkFormWidgetDateEntryPrivate GtkFormWidgetDateEntryPrivate;
 struct _GtkFormWidgetDateEntryPrivate
 	{
-		gpointer foo;
+		/* the loaded value, as gtk_date_entry_get_packed () */
+		gint64 origin;
 	};
 
 
@@ -60,6 +65,18 @@ gtk_form_widget_date_entry_class_init (GtkFormWidgetDateEntryClass *klass)
 
 	widget_class->get_value_stringify = gtk_form_widget_date_entry_get_value_stringify;
 	widget_class->set_value_stringify = gtk_form_widget_date_entry_set_value_stringify;
+#ifdef HAVE_GTKFORMWIDGETCLASS_GET_VALUE
+	widget_class->get_value = gtk_form_widget_date_entry_get_value;
+#endif
+#ifdef HAVE_GTKFORMWIDGETCLASS_SET_VALUE
+	widget_class->set_value = gtk_form_widget_date_entry_set_value;
+#endif
+#ifdef HAVE_GTKFORMWIDGETCLASS_IS_CHANGED
+	widget_class->is_changed = gtk_form_widget_date_entry_is_changed;
+#endif
+#ifdef HAVE_GTKFORMWIDGETCLASS_SET_AS_ORIGIN
+	widget_class->set_as_origin = gtk_form_widget_date_entry_set_as_origin;
+#endif
 	widget_class->set_editable = gtk_form_widget_date_entry_set_editable;
 
 	g_type_class_add_private (object_class, sizeof (GtkFormWidgetDateEntryPrivate));
@@ -85,40 +102,151 @@ GtkFormWidget
  * gtk_form_widget_date_entry_get_value_stringify:
  * @widget:
  *
+ * Returns: the value as an sql timestamp, written with the format shared
+ * by all the entries.
  */
 gchar
 *gtk_form_widget_date_entry_get_value_stringify (GtkFormWidget *fwidget)
 {
-	GtkFormWidgetDateEntryPrivate *priv = GTK_FORM_WIDGET_DATE_ENTRY_GET_PRIVATE (fwidget);
-
 	GtkWidget *w = gtk_form_widget_get_widget (fwidget);
 
-	return g_strdup (gtk_date_entry_get_strf (GTK_DATE_ENTRY (w), "Ymd HMS", "-", ":"));
+	return gtk_date_entry_dup_sql (GTK_DATE_ENTRY (w));
 }
 
 /**
  * gtk_form_widget_date_entry_set_value_stringify:
  * @fwidget:
- * @value:
+ * @value: an sql date or timestamp.
  *
+ * Sets the value and takes it as the loaded one, see
+ * gtk_form_widget_date_entry_is_changed().
  */
 gboolean
 gtk_form_widget_date_entry_set_value_stringify (GtkFormWidget *fwidget, const gchar *value)
 {
-	gboolean ret = FALSE;
-	GtkWidget *w;
+	gboolean ret;
+
+	GtkWidget *w = gtk_form_widget_get_widget (fwidget);
+
+	ret = gtk_date_entry_set_sql (GTK_DATE_ENTRY (w), value);
+	gtk_form_widget_date_entry_set_as_origin (fwidget);
+
+	return ret;
+}
+
+/**
+ * gtk_form_widget_date_entry_get_value:
+ * @fwidget:
+ *
+ * Returns: (transfer full): a newly allocated #GValue holding a
+ * #GDateTime, NULL if the date isn't valid: no string is formatted and
+ * parsed again.
+ */
+GValue
+*gtk_form_widget_date_entry_get_value (GtkFormWidget *fwidget)
+{
+	GValue *ret;
+	GDateTime *gdatetime;
 
-	g_object_get (G_OBJECT (fwidget),
-	              "widget", &w,
-	              NULL);
+	GtkWidget *w = gtk_form_widget_get_widget (fwidget);
 
-	gtk_entry_set_text (GTK_ENTRY (w), value);
+	gdatetime = gtk_date_entry_get_gdatetime (GTK_DATE_ENTRY (w));
+	if (gdatetime == NULL)
+		{
+			return NULL;
+		}
+
+	ret = g_new0 (GValue, 1);
+	g_value_init (ret, G_TYPE_DATE_TIME);
+	g_value_take_boxed (ret, gdatetime);
+
+	return ret;
+}
+
+/**
+ * gtk_form_widget_date_entry_set_value:
+ * @fwidget:
+ * @value: a #GValue holding a #GDateTime, a #GDate, a #gint64 with the
+ * microseconds since the epoch, or an sql date or timestamp as a string.
+ *
+ * Sets the value and takes it as the loaded one, see
+ * gtk_form_widget_date_entry_is_changed().
+ *
+ * Returns: FALSE if the type of @value isn't one of the above.
+ */
+gboolean
+gtk_form_widget_date_entry_set_value (GtkFormWidget *fwidget, GValue *value)
+{
+	GtkDateEntry *date;
+	gboolean ret;
+
+	g_return_val_if_fail (G_IS_VALUE (value), FALSE);
+
+	date = GTK_DATE_ENTRY (gtk_form_widget_get_widget (fwidget));
 
 	ret = TRUE;
 
+	if (G_VALUE_HOLDS (value, G_TYPE_DATE_TIME))
+		{
+			gtk_date_entry_set_date_gdatetime (date, g_value_get_boxed (value));
+		}
+	else if (G_VALUE_HOLDS (value, G_TYPE_DATE))
+		{
+			gtk_date_entry_set_date_gdate (date, g_value_get_boxed (value));
+		}
+	else if (G_VALUE_HOLDS_INT64 (value))
+		{
+			gtk_date_entry_set_unix_usec (date, g_value_get_int64 (value));
+		}
+	else if (G_VALUE_HOLDS_STRING (value))
+		{
+			ret = gtk_date_entry_set_sql (date, g_value_get_string (value));
+		}
+	else
+		{
+			return FALSE;
+		}
+
+	gtk_form_widget_date_entry_set_as_origin (fwidget);
+
 	return ret;
 }
 
+/**
+ * gtk_form_widget_date_entry_set_as_origin:
+ * @fwidget:
+ *
+ * Takes the current value as the loaded one, e.g. after it is saved.
+ */
+void
+gtk_form_widget_date_entry_set_as_origin (GtkFormWidget *fwidget)
+{
+	g_return_if_fail (GTK_FORM_IS_WIDGET_DATE_ENTRY (fwidget));
+
+	GtkFormWidgetDateEntryPrivate *priv = GTK_FORM_WIDGET_DATE_ENTRY_GET_PRIVATE (fwidget);
+
+	priv->origin = gtk_date_entry_get_packed (GTK_DATE_ENTRY (gtk_form_widget_get_widget (fwidget)));
+}
+
+/**
+ * gtk_form_widget_date_entry_is_changed:
+ * @fwidget:
+ *
+ * Compares the entry's cached value with the loaded one, without
+ * formatting it, so the unchanged dates can be left out of an UPDATE.
+ *
+ * Returns: TRUE if the value isn't the loaded one.
+ */
+gboolean
+gtk_form_widget_date_entry_is_changed (GtkFormWidget *fwidget)
+{
+	g_return_val_if_fail (GTK_FORM_IS_WIDGET_DATE_ENTRY (fwidget), FALSE);
+
+	GtkFormWidgetDateEntryPrivate *priv = GTK_FORM_WIDGET_DATE_ENTRY_GET_PRIVATE (fwidget);
+
+	return gtk_date_entry_get_packed (GTK_DATE_ENTRY (gtk_form_widget_get_widget (fwidget))) != priv->origin;
+}
+
 /**
  * gtk_form_widget_set_editable:
  * @fwidget:
@@ -128,13 +256,9 @@ gtk_form_widget_date_entry_set_value_stringify (GtkFormWidget *fwidget, const gc
 void
 gtk_form_widget_date_entry_set_editable (GtkFormWidget *fwidget, gboolean editable)
 {
-	GtkWidget *w;
-
-	g_object_get (G_OBJECT (fwidget),
-	              "widget", &w,
-	              NULL);
+	GtkWidget *w = gtk_form_widget_get_widget (fwidget);
 
-	gtk_editable_set_editable (GTK_EDITABLE (w), editable);
+	gtk_date_entry_set_editable (GTK_DATE_ENTRY (w), editable);
 }
 
 /* PRIVATE */
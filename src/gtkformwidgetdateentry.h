@@ -54,6 +54,12 @@ gchar *gtk_form_widget_date_entry_get_value_stringify (GtkFormWidget *widget);
 
 gboolean gtk_form_widget_date_entry_set_value_stringify (GtkFormWidget *fwidget, const gchar *value);
 
+GValue *gtk_form_widget_date_entry_get_value (GtkFormWidget *fwidget);
+gboolean gtk_form_widget_date_entry_set_value (GtkFormWidget *fwidget, GValue *value);
+
+void gtk_form_widget_date_entry_set_as_origin (GtkFormWidget *fwidget);
+gboolean gtk_form_widget_date_entry_is_changed (GtkFormWidget *fwidget);
+
 void gtk_form_widget_date_entry_set_editable (GtkFormWidget *fwidget, gboolean editable);
 
 
@@ -0,0 +1,120 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Measures the time and the resident memory needed to build many
+ * GtkDateEntry, packed in a window as a form does.
+ *
+ * Usage: bench_construct [number of entries...]
+ * (default: 1000 10000)
+ *
+ * To compare two versions of the library, run it built against each one,
+ * on the same display and with the same counts, and compare the lines.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <gtk/gtk.h>
+
+#include <gtkdateentry.h>
+
+/* resident memory in KiB, 0 if it can't be read */
+static glong
+get_rss (void)
+{
+	gchar *contents;
+	glong pages;
+
+	pages = 0;
+	if (g_file_get_contents ("/proc/self/statm", &contents, NULL, NULL))
+		{
+			sscanf (contents, "%*ld %ld", &pages);
+			g_free (contents);
+		}
+
+	return pages * (sysconf (_SC_PAGESIZE) / 1024);
+}
+
+static void
+bench (guint n)
+{
+	GtkWidget *window;
+	GtkWidget *box;
+	guint i;
+	gint64 start;
+	gint64 usec;
+	glong rss;
+
+	rss = get_rss ();
+	start = g_get_monotonic_time ();
+
+	window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+	box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+	gtk_container_add (GTK_CONTAINER (window), box);
+	for (i = 0; i < n; i++)
+		{
+			gtk_box_pack_start (GTK_BOX (box),
+			                    gtk_date_entry_new (NULL, NULL, TRUE),
+			                    FALSE, FALSE, 0);
+		}
+
+	usec = g_get_monotonic_time () - start;
+	rss = get_rss () - rss;
+
+	g_print ("%6u entries: %8.3f ms, %8.2f us/entry, %8ld KiB RSS, %6.2f KiB/entry\n",
+	         n, usec / 1000.0, (gdouble)usec / n, rss, (gdouble)rss / n);
+
+	gtk_widget_destroy (window);
+}
+
+int
+main (int argc, char **argv)
+{
+	gint i;
+	guint n;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	/* types and locale's data are loaded once, outside the measures */
+	bench (1);
+
+	if (argc < 2)
+		{
+			bench (1000);
+			bench (10000);
+		}
+	for (i = 1; i < argc; i++)
+		{
+			n = strtoul (argv[i], NULL, 10);
+			if (n > 0)
+				{
+					bench (n);
+				}
+		}
+
+	return 0;
+}
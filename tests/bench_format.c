@@ -0,0 +1,119 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Compares the throughput, in values per second, of formatting many dates
+ * through a GtkDateEntry (set the value, then gtk_date_entry_get_strf) and
+ * with gtk_date_format_format_many into one buffer.
+ *
+ * Usage: bench_format [number of values]
+ */
+
+#include <stdlib.h>
+
+#include <gtk/gtk.h>
+
+#include <gtkdateentry.h>
+
+#define STRIDE 20
+
+static void
+report (const gchar *name, gsize n, gint64 usec)
+{
+	g_print ("%-20s %10" G_GSIZE_FORMAT " values in %8.3f s: %12.0f values/s\n",
+	         name, n, usec / 1000000.0,
+	         usec > 0 ? n * 1000000.0 / usec : 0.0);
+}
+
+int
+main (int argc, char **argv)
+{
+	GtkWidget *date;
+	GtkDateFormat *fmt;
+
+	gsize n;
+	gsize i;
+	gint32 *julian;
+	gint32 *seconds;
+	gchar *buf;
+	GDateTime *gdatetime;
+	GDate gdate;
+	gint64 start;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	n = argc > 1 ? strtoul (argv[1], NULL, 10) : 100000;
+	if (n == 0)
+		{
+			n = 100000;
+		}
+
+	/* one day and a few seconds apart, starting from 2000-01-01 */
+	julian = g_new (gint32, n);
+	seconds = g_new (gint32, n);
+	g_date_clear (&gdate, 1);
+	g_date_set_dmy (&gdate, 1, 1, 2000);
+	for (i = 0; i < n; i++)
+		{
+			julian[i] = g_date_get_julian (&gdate) + i % 3000;
+			seconds[i] = (i * 37) % 86400;
+		}
+
+	date = gtk_date_entry_new ("Ymd", "-", FALSE);
+	gtk_date_entry_set_time_visible (GTK_DATE_ENTRY (date), TRUE);
+	g_object_ref_sink (date);
+
+	start = g_get_monotonic_time ();
+	for (i = 0; i < n; i++)
+		{
+			g_date_set_julian (&gdate, julian[i]);
+			gdatetime = g_date_time_new_local (g_date_get_year (&gdate),
+			                                   g_date_get_month (&gdate),
+			                                   g_date_get_day (&gdate),
+			                                   seconds[i] / 3600,
+			                                   (seconds[i] / 60) % 60,
+			                                   seconds[i] % 60);
+			gtk_date_entry_set_date_gdatetime (GTK_DATE_ENTRY (date), gdatetime);
+			g_date_time_unref (gdatetime);
+
+			gtk_date_entry_get_strf (GTK_DATE_ENTRY (date), "YmdHMS", "-", ":");
+		}
+	report ("get_strf", n, g_get_monotonic_time () - start);
+
+	fmt = gtk_date_format_new ("YmdHMS", "-", ":");
+	buf = g_malloc (n * STRIDE);
+
+	start = g_get_monotonic_time ();
+	gtk_date_format_format_many (fmt, julian, seconds, n, buf, STRIDE);
+	report ("format_many", n, g_get_monotonic_time () - start);
+
+	g_free (buf);
+	gtk_date_format_unref (fmt);
+	g_object_unref (date);
+	g_free (julian);
+	g_free (seconds);
+
+	return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+
+/*
+ * Checks the business days of a GtkDateCalendarRules loaded from a file.
+ */
+
+#include <glib/gstdio.h>
+
+#include <gtkdatecalendarrules.h>
+
+static guint32
+julian (gint day, gint month, gint year)
+{
+	GDate gdate;
+
+	g_date_clear (&gdate, 1);
+	g_date_set_dmy (&gdate, day, month, year);
+
+	return g_date_get_julian (&gdate);
+}
+
+int
+main (int argc, char **argv)
+{
+	GtkDateCalendarRules *rules;
+	GError *error;
+	gchar *filename;
+	gint fd;
+	gboolean ok;
+
+	ok = TRUE;
+
+	fd = g_file_open_tmp ("calendar_rules-XXXXXX", &filename, NULL);
+	if (fd < 0)
+		{
+			/* no temporary directory: skip */
+			return 77;
+		}
+	g_close (fd, NULL);
+	g_file_set_contents (filename,
+	                     "# the italian holidays\n"
+	                     "weekend 6 7\n"
+	                     "\n"
+	                     "12-25\n"
+	                     "2014-04-21\n",
+	                     -1, NULL);
+
+	rules = gtk_date_calendar_rules_new ();
+
+	error = NULL;
+	if (!gtk_date_calendar_rules_load_from_file (rules, filename, &error))
+		{
+			g_printerr ("%s\n", error->message);
+			g_error_free (error);
+			ok = FALSE;
+		}
+
+	/* Friday 2014-12-19, then Christmas, a weekend and Easter Monday */
+	if (!gtk_date_calendar_rules_is_business_day (rules, julian (19, 12, 2014))
+	    || gtk_date_calendar_rules_is_business_day (rules, julian (20, 12, 2014))
+	    || gtk_date_calendar_rules_is_business_day (rules, julian (25, 12, 2014))
+	    || gtk_date_calendar_rules_is_business_day (rules, julian (25, 12, 2030))
+	    || gtk_date_calendar_rules_is_business_day (rules, julian (21, 4, 2014))
+	    || !gtk_date_calendar_rules_is_business_day (rules, julian (21, 4, 2015)))
+		{
+			g_printerr ("wrong business days\n");
+			ok = FALSE;
+		}
+
+	/* from Wednesday 2014-12-24 over Christmas to Friday */
+	if (gtk_date_calendar_rules_next_business_day (rules, julian (24, 12, 2014)) != julian (26, 12, 2014)
+	    || gtk_date_calendar_rules_next_business_day (rules, julian (31, 12, 2014)) != julian (1, 1, 2015))
+		{
+			g_printerr ("wrong next business day\n");
+			ok = FALSE;
+		}
+
+	/* February 2015 starts on Sunday: the weekdays from the 2nd */
+	if (gtk_date_calendar_rules_get_business_days (rules, 2015, G_DATE_FEBRUARY) != 0x7cf9f3e)
+		{
+			g_printerr ("wrong business days of the month: %x\n",
+			            gtk_date_calendar_rules_get_business_days (rules, 2015, G_DATE_FEBRUARY));
+			ok = FALSE;
+		}
+
+	/* a wrong line doesn't change the rules */
+	g_file_set_contents (filename, "weekend 1\n13-01\n", -1, NULL);
+	if (gtk_date_calendar_rules_load_from_file (rules, filename, NULL)
+	    || gtk_date_calendar_rules_is_weekend_day (rules, G_DATE_MONDAY))
+		{
+			g_printerr ("a wrong file is loaded\n");
+			ok = FALSE;
+		}
+
+	g_object_unref (rules);
+	g_unlink (filename);
+	g_free (filename);
+
+	return ok ? 0 : 1;
+}
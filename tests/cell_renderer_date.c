@@ -0,0 +1,145 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+
+/*
+ * Checks that GtkCellRendererDate takes packed values and julian days,
+ * that its size doesn't depend on the value, and that one GtkDateEntry
+ * edits all the rows.
+ */
+
+#include <gtk/gtk.h>
+
+#include <gtkcellrendererdate.h>
+
+static gchar *edited_path = NULL;
+static gint64 edited_packed = 0;
+
+static void
+on_edited (GtkCellRendererDate *cell, const gchar *path, gint64 packed, gpointer user_data)
+{
+	g_free (edited_path);
+	edited_path = g_strdup (path);
+	edited_packed = packed;
+}
+
+int
+main (int argc, char **argv)
+{
+	GtkCellRenderer *cell;
+	GtkCellEditable *editor;
+	GtkCellEditable *editor2;
+	GdkRectangle area = { 0, 0, 100, 20 };
+	GtkWidget *view;
+	gint width;
+	gint again;
+	guint julian;
+	gchar *format;
+	gboolean ok;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	ok = TRUE;
+
+	view = gtk_tree_view_new ();
+	g_object_ref_sink (view);
+
+	cell = gtk_cell_renderer_date_new ();
+	g_object_ref_sink (cell);
+	g_object_set (cell,
+	              "format", "Ymd",
+	              "separator", "-",
+	              "time-visible", TRUE,
+	              "packed", GTK_DATE_ENTRY_PACK (734566, 3600),
+	              NULL);
+
+	g_object_get (cell, "julian", &julian, "format", &format, NULL);
+	if (julian != 734566 || g_strcmp0 (format, "Ymd") != 0)
+		{
+			g_printerr ("wrong properties: %u, %s\n", julian, format);
+			ok = FALSE;
+		}
+	g_free (format);
+
+	gtk_cell_renderer_get_preferred_width (cell, view, &width, NULL);
+	g_object_set (cell, "julian", 735000, NULL);
+	gtk_cell_renderer_get_preferred_width (cell, view, &again, NULL);
+	if (width <= 0 || again != width)
+		{
+			g_printerr ("the width changes with the value: %d, %d\n", width, again);
+			ok = FALSE;
+		}
+
+	/* without the time the cell is narrower */
+	g_object_set (cell, "time-visible", FALSE, NULL);
+	gtk_cell_renderer_get_preferred_width (cell, view, &again, NULL);
+	if (again >= width)
+		{
+			g_printerr ("the width doesn't follow the format\n");
+			ok = FALSE;
+		}
+
+	/* the same entry edits two rows */
+	g_object_set (cell, "editable", TRUE, NULL);
+	g_signal_connect (cell, "edited", G_CALLBACK (on_edited), NULL);
+
+	editor = gtk_cell_renderer_start_editing (cell, NULL, view, "3", &area, &area, 0);
+	if (!GTK_IS_DATE_ENTRY (editor)
+	    || gtk_date_entry_get_julian (GTK_DATE_ENTRY (editor)) != 735000)
+		{
+			g_printerr ("the editor doesn't have the cell's value\n");
+			return 1;
+		}
+	gtk_date_entry_set_julian_seconds (GTK_DATE_ENTRY (editor), 735001, 0);
+	gtk_cell_editable_editing_done (editor);
+	if (g_strcmp0 (edited_path, "3") != 0
+	    || edited_packed != GTK_DATE_ENTRY_PACK (735001, 0))
+		{
+			g_printerr ("\"edited\" not emitted for the row\n");
+			ok = FALSE;
+		}
+
+	editor2 = gtk_cell_renderer_start_editing (cell, NULL, view, "7", &area, &area, 0);
+	if (editor2 != editor)
+		{
+			g_printerr ("a new editor for every row\n");
+			ok = FALSE;
+		}
+
+	/* canceled: no "edited" */
+	g_object_set (editor2, "editing-canceled", TRUE, NULL);
+	gtk_cell_editable_editing_done (editor2);
+	if (g_strcmp0 (edited_path, "3") != 0)
+		{
+			g_printerr ("\"edited\" emitted for a canceled editing\n");
+			ok = FALSE;
+		}
+
+	g_free (edited_path);
+	g_object_unref (cell);
+	g_object_unref (view);
+
+	return ok ? 0 : 1;
+}
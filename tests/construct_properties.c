@@ -0,0 +1,122 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Checks that the construct properties given to g_object_new() and to
+ * GtkBuilder configure the entry, without calling the setters afterwards.
+ */
+
+#include <string.h>
+
+#include <gtk/gtk.h>
+
+#include <gtkdateentry.h>
+
+static const gchar *ui =
+	"<interface>"
+	"  <object class=\"GtkWindow\" id=\"window\">"
+	"    <child>"
+	"      <object class=\"GtkDateEntry\" id=\"date\">"
+	"        <property name=\"format\">Ymd</property>"
+	"        <property name=\"separator\">-</property>"
+	"        <property name=\"time-visible\">False</property>"
+	"        <property name=\"calendar-button-visible\">False</property>"
+	"      </object>"
+	"    </child>"
+	"  </object>"
+	"</interface>";
+
+static gboolean
+check (GtkWidget *date, const gchar *text, const gchar *what)
+{
+	gboolean time_visible;
+	gboolean button_visible;
+	gchar buf[32];
+	gboolean ret;
+
+	g_object_get (date,
+	              "time-visible", &time_visible,
+	              "calendar-button-visible", &button_visible,
+	              NULL);
+
+	/* the text is written with the constructed format */
+	gtk_date_entry_set_julian_seconds (GTK_DATE_ENTRY (date), 734566, 0);
+	gtk_date_entry_get_text_into (GTK_DATE_ENTRY (date), buf, sizeof (buf));
+
+	ret = !time_visible && !button_visible && strcmp (buf, text) == 0;
+	if (!ret)
+		{
+			g_printerr ("%s: time %d, button %d, text \"%s\" instead of \"%s\"\n",
+			            what, time_visible, button_visible, buf, text);
+		}
+
+	return ret;
+}
+
+int
+main (int argc, char **argv)
+{
+	GtkWidget *window;
+	GtkWidget *date;
+	GtkBuilder *builder;
+	GDate gdate;
+	gchar text[32];
+	GError *error;
+	gboolean ok;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	ok = TRUE;
+
+	g_date_clear (&gdate, 1);
+	g_date_set_julian (&gdate, 734566);
+	g_date_strftime (text, sizeof (text), "%Y-%m-%d", &gdate);
+
+	window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+	date = GTK_WIDGET (g_object_new (GTK_TYPE_DATE_ENTRY,
+	                                 "format", "Ymd",
+	                                 "separator", "-",
+	                                 "time-visible", FALSE,
+	                                 "calendar-button-visible", FALSE,
+	                                 NULL));
+	gtk_container_add (GTK_CONTAINER (window), date);
+	ok &= check (date, text, "g_object_new");
+	gtk_widget_destroy (window);
+
+	/* the type is registered by now, so GtkBuilder finds it */
+	builder = gtk_builder_new ();
+	error = NULL;
+	if (!gtk_builder_add_from_string (builder, ui, -1, &error))
+		{
+			g_printerr ("%s\n", error->message);
+			g_error_free (error);
+			return 1;
+		}
+	ok &= check (GTK_WIDGET (gtk_builder_get_object (builder, "date")), text, "GtkBuilder");
+	gtk_widget_destroy (GTK_WIDGET (gtk_builder_get_object (builder, "window")));
+	g_object_unref (builder);
+
+	return ok ? 0 : 1;
+}
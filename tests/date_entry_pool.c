@@ -0,0 +1,162 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Checks that an entry given back to a GtkDateEntryPool is handed out
+ * again cleared, without the user's signal handlers, blocked or not, with
+ * the default properties and the widget's state reset.
+ */
+
+#include <gtk/gtk.h>
+
+#include <gtkdateentrypool.h>
+
+static guint notified = 0;
+static guint blocked_changed = 0;
+
+static void
+on_notify (GObject *object, GParamSpec *pspec, gpointer user_data)
+{
+	notified++;
+}
+
+static void
+on_blocked_value_changed (GtkDateEntry *date, gint64 packed, gpointer user_data)
+{
+	blocked_changed++;
+}
+
+int
+main (int argc, char **argv)
+{
+	GtkDateEntryPool *pool;
+	GtkWidget *window;
+	GtkWidget *date;
+	GtkWidget *again;
+	gulong blocked_id;
+	gchar *separator;
+	gint width;
+	guint hits;
+	guint misses;
+	guint high_water;
+	gboolean ok;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	ok = TRUE;
+
+	pool = gtk_date_entry_pool_new (4);
+	window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+
+	date = gtk_date_entry_pool_acquire (pool);
+	gtk_container_add (GTK_CONTAINER (window), date);
+	g_signal_connect (date, "notify::julian", G_CALLBACK (on_notify), NULL);
+	blocked_id = g_signal_connect (date, "value-changed", G_CALLBACK (on_blocked_value_changed), NULL);
+	g_signal_handler_block (date, blocked_id);
+
+	gtk_widget_set_name (date, "invoice-date");
+	gtk_widget_set_size_request (date, 200, -1);
+	gtk_widget_set_margin_top (date, 6);
+	gtk_style_context_add_class (gtk_widget_get_style_context (date), "due");
+
+	gtk_date_entry_set_time_visible (GTK_DATE_ENTRY (date), FALSE);
+	gtk_date_entry_set_time_separator (GTK_DATE_ENTRY (date), ".");
+	gtk_date_entry_set_julian_seconds (GTK_DATE_ENTRY (date), 734566, 0);
+	if (notified == 0 || !gtk_date_entry_is_valid (GTK_DATE_ENTRY (date)))
+		{
+			g_printerr ("the entry isn't set\n");
+			ok = FALSE;
+		}
+
+	gtk_date_entry_pool_release (pool, GTK_DATE_ENTRY (date));
+	if (gtk_widget_get_parent (date) != NULL)
+		{
+			g_printerr ("the released entry is still in its container\n");
+			ok = FALSE;
+		}
+
+	again = gtk_date_entry_pool_acquire (pool);
+	if (again != date)
+		{
+			g_printerr ("the released entry isn't handed out again\n");
+			ok = FALSE;
+		}
+	if (gtk_date_entry_is_valid (GTK_DATE_ENTRY (again))
+	    || !gtk_date_entry_is_time_visible (GTK_DATE_ENTRY (again)))
+		{
+			g_printerr ("the released entry isn't reset\n");
+			ok = FALSE;
+		}
+
+	g_object_get (again, "time-separator", &separator, NULL);
+	if (g_strcmp0 (separator, ":") != 0)
+		{
+			g_printerr ("the time separator isn't reset: \"%s\"\n", separator);
+			ok = FALSE;
+		}
+	g_free (separator);
+
+	if (g_strcmp0 (gtk_widget_get_name (again), "GtkDateEntry") != 0
+	    || gtk_widget_get_margin_top (again) != 0
+	    || gtk_style_context_has_class (gtk_widget_get_style_context (again), "due"))
+		{
+			g_printerr ("the widget's state isn't reset\n");
+			ok = FALSE;
+		}
+	gtk_widget_get_size_request (again, &width, NULL);
+	if (width != -1)
+		{
+			g_printerr ("the size request isn't reset: %d\n", width);
+			ok = FALSE;
+		}
+
+	if (g_signal_handler_is_connected (again, blocked_id))
+		{
+			g_printerr ("the user's blocked handler is still connected\n");
+			ok = FALSE;
+		}
+
+	notified = 0;
+	gtk_date_entry_set_julian_seconds (GTK_DATE_ENTRY (again), 734566, 0);
+	if (notified != 0)
+		{
+			g_printerr ("the user's handler is still connected\n");
+			ok = FALSE;
+		}
+
+	gtk_date_entry_pool_get_stats (pool, &hits, &misses, &high_water);
+	if (hits != 1 || misses != 1 || high_water != 1)
+		{
+			g_printerr ("wrong statistics: %u hits, %u misses, %u high water\n",
+			            hits, misses, high_water);
+			ok = FALSE;
+		}
+
+	gtk_container_add (GTK_CONTAINER (window), again);
+	gtk_widget_destroy (window);
+	g_object_unref (pool);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Checks the segment-wise keyboard editing of a GtkDateField, and its
+ * value API shared with GtkDateEntry.
+ */
+
+#include <string.h>
+
+#include <gtk/gtk.h>
+
+#include <gtkdatefield.h>
+
+static void
+press (GtkWidget *widget, guint keyval)
+{
+	GdkEvent *event;
+
+	event = gdk_event_new (GDK_KEY_PRESS);
+	event->key.window = g_object_ref (gtk_widget_get_window (widget));
+	event->key.keyval = keyval;
+	event->key.time = GDK_CURRENT_TIME;
+	gtk_widget_event (widget, event);
+	gdk_event_free (event);
+}
+
+static void
+on_value_changed (GtkDateField *field, gint64 packed, gpointer user_data)
+{
+	(*(guint *)user_data)++;
+}
+
+static void
+type (GtkWidget *widget, const gchar *keys)
+{
+	for (; *keys != '\0'; keys++)
+		{
+			press (widget, gdk_unicode_to_keyval (*keys));
+		}
+}
+
+int
+main (int argc, char **argv)
+{
+	GtkWidget *window;
+	GtkWidget *field;
+	GDate gdate;
+	gchar buf[32];
+	guint emitted;
+	gboolean ok;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	ok = TRUE;
+
+	window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+	field = gtk_date_field_new ("dmY", "/");
+	gtk_date_field_set_time_visible (GTK_DATE_FIELD (field), FALSE);
+	gtk_container_add (GTK_CONTAINER (window), field);
+	gtk_widget_realize (field);
+
+	/* the digits fill a segment and go to the next one */
+	type (field, "04032012");
+	g_date_clear (&gdate, 1);
+	g_date_set_dmy (&gdate, 4, 3, 2012);
+	if (gtk_date_field_get_julian (GTK_DATE_FIELD (field)) != g_date_get_julian (&gdate))
+		{
+			g_printerr ("typed date not read\n");
+			ok = FALSE;
+		}
+
+	/* a digit that can't be followed by another one goes to the next one */
+	press (field, GDK_KEY_Home);
+	type (field, "5");
+	gtk_date_field_get_text_into (GTK_DATE_FIELD (field), buf, sizeof (buf));
+	if (strcmp (buf, "05/03/2012") != 0)
+		{
+			g_printerr ("\"%s\" instead of 05/03/2012\n", buf);
+			ok = FALSE;
+		}
+
+	/* Up and Down step the segment, wrapping at the month's end */
+	press (field, GDK_KEY_Home);
+	press (field, GDK_KEY_Down);
+	press (field, GDK_KEY_Down);
+	press (field, GDK_KEY_Down);
+	press (field, GDK_KEY_Down);
+	press (field, GDK_KEY_Down);
+	gtk_date_field_get_text_into (GTK_DATE_FIELD (field), buf, sizeof (buf));
+	if (strcmp (buf, "31/03/2012") != 0)
+		{
+			g_printerr ("\"%s\" instead of 31/03/2012\n", buf);
+			ok = FALSE;
+		}
+
+	/* an empty segment leaves the date not valid */
+	press (field, GDK_KEY_BackSpace);
+	if (gtk_date_field_is_valid (GTK_DATE_FIELD (field)))
+		{
+			g_printerr ("date valid with an empty segment\n");
+			ok = FALSE;
+		}
+
+	/* the sql setter and getter, and one "value-changed" for a change */
+	emitted = 0;
+	g_signal_connect (field, "value-changed", G_CALLBACK (on_value_changed), &emitted);
+	if (!gtk_date_field_set_sql (GTK_DATE_FIELD (field), "2012-03-04")
+	    || strcmp (gtk_date_field_get_sql (GTK_DATE_FIELD (field)), "2012-03-04") != 0)
+		{
+			g_printerr ("sql date not set\n");
+			ok = FALSE;
+		}
+	gtk_date_field_set_sql (GTK_DATE_FIELD (field), "2012-03-04");
+	if (emitted != 1)
+		{
+			g_printerr ("%u value-changed instead of 1\n", emitted);
+			ok = FALSE;
+		}
+
+	/* the setters move a date before "min-date" to it, a typed one isn't
+	 * valid */
+	g_date_set_dmy (&gdate, 10, 3, 2012);
+	gtk_date_field_set_min_date (GTK_DATE_FIELD (field), g_date_get_julian (&gdate));
+	if (gtk_date_field_get_julian (GTK_DATE_FIELD (field)) != g_date_get_julian (&gdate))
+		{
+			g_printerr ("date not moved to min-date\n");
+			ok = FALSE;
+		}
+	press (field, GDK_KEY_Home);
+	type (field, "05");
+	if (gtk_date_field_is_valid (GTK_DATE_FIELD (field))
+	    || !gtk_date_field_is_complete (GTK_DATE_FIELD (field)))
+		{
+			g_printerr ("typed date before min-date is valid\n");
+			ok = FALSE;
+		}
+
+	gtk_widget_destroy (window);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+
+#include <gtkdateformat.h>
+
+static const gchar *strs[] =
+{
+	"2012-03-04 10:11:12",
+	"2012-03-04",
+	"2012-03-04 10:11",
+	"2012-02-29 23:59:59",
+	"2013-02-29 00:00:00",
+	"2012-13-01 00:00:00",
+	"2012-03-04 24:00:00",
+	"0001-01-01 00:00:00",
+	"9999-12-31 23:59:59",
+	"2012/03/04T10.11.12",
+	"2012-03-04 1x:11:12",
+	"2012-0",
+	"",
+	NULL
+};
+
+int
+main (int argc, char **argv)
+{
+	GtkDateFormat *fmt;
+	GtkDateFormat *fmt_it;
+	GtkDateFormat *fmt_long;
+
+	gint32 julian[G_N_ELEMENTS (strs)];
+	gint32 seconds[G_N_ELEMENTS (strs)];
+	guint8 valid[G_N_ELEMENTS (strs)];
+
+	gint32 j;
+	gint32 s;
+	gboolean ok;
+	gsize n_valid;
+	gsize i;
+	gchar buf[32];
+	gchar many[G_N_ELEMENTS (strs)][20];
+	GDate gdate;
+
+	ok = TRUE;
+
+	fmt = gtk_date_format_new ("YmdHMS", "-", ":");
+	fmt_it = gtk_date_format_new ("dmYHMS", "/", ".");
+
+	/* the batch parser must agree with the single one */
+	n_valid = gtk_date_format_parse_many (fmt, strs, G_N_ELEMENTS (strs), julian, seconds, valid);
+	for (i = 0; i < G_N_ELEMENTS (strs); i++)
+		{
+			gboolean v = gtk_date_format_parse (fmt, strs[i], &j, &s);
+
+			if (v != valid[i] || j != julian[i] || s != seconds[i])
+				{
+					g_printerr ("\"%s\": parse_many doesn't agree with parse\n", strs[i]);
+					ok = FALSE;
+				}
+			n_valid -= v;
+		}
+	if (n_valid != 0)
+		{
+			g_printerr ("wrong number of valid dates from parse_many\n");
+			ok = FALSE;
+		}
+
+	/* julian days are the same of GDate */
+	g_date_clear (&gdate, 1);
+	g_date_set_dmy (&gdate, 4, 3, 2012);
+	if (julian[0] != (gint32)g_date_get_julian (&gdate) || seconds[0] != 36672)
+		{
+			g_printerr ("wrong julian day or seconds\n");
+			ok = FALSE;
+		}
+
+	/* round trip with another layout */
+	if (gtk_date_format_format (fmt_it, julian[0], seconds[0], buf, sizeof (buf)) != 19
+	    || strcmp (buf, "04/03/2012 10.11.12") != 0)
+		{
+			g_printerr ("wrong formatted string \"%s\"\n", buf);
+			ok = FALSE;
+		}
+	if (!gtk_date_format_parse (fmt_it, buf, &j, &s)
+	    || j != julian[0] || s != seconds[0])
+		{
+			g_printerr ("\"%s\": round trip failed\n", buf);
+			ok = FALSE;
+		}
+	if (gtk_date_format_format_date (fmt_it, julian[0], buf, sizeof (buf)) != 10
+	    || strcmp (buf, "04/03/2012") != 0)
+		{
+			g_printerr ("wrong formatted date \"%s\"\n", buf);
+			ok = FALSE;
+		}
+
+	/* round trip with separators longer than one char, and empty */
+	fmt_long = gtk_date_format_new ("dmYHMS", " - ", "");
+	if (gtk_date_format_format (fmt_long, julian[0], seconds[0], buf, sizeof (buf)) != 21
+	    || strcmp (buf, "04 - 03 - 2012 101112") != 0)
+		{
+			g_printerr ("wrong formatted string \"%s\"\n", buf);
+			ok = FALSE;
+		}
+	if (!gtk_date_format_parse (fmt_long, buf, &j, &s)
+	    || j != julian[0] || s != seconds[0])
+		{
+			g_printerr ("\"%s\": round trip failed\n", buf);
+			ok = FALSE;
+		}
+	gtk_date_format_unref (fmt_long);
+
+	/* a short buffer is left empty and the needed length is returned */
+	if (gtk_date_format_format (fmt, julian[0], seconds[0], buf, 10) != 19
+	    || buf[0] != '\0')
+		{
+			g_printerr ("short buffer not handled\n");
+			ok = FALSE;
+		}
+
+	/* the batch formatter must agree with the single one */
+	n_valid = gtk_date_format_format_many (fmt_it, julian, seconds, G_N_ELEMENTS (strs), many[0], sizeof (many[0]));
+	for (i = 0; i < G_N_ELEMENTS (strs); i++)
+		{
+			n_valid -= gtk_date_format_format (fmt_it, julian[i], seconds[i], buf, sizeof (buf)) > 0;
+			if (strcmp (buf, many[i]) != 0)
+				{
+					g_printerr ("\"%s\": format_many doesn't agree with format\n", buf);
+					ok = FALSE;
+				}
+		}
+	if (n_valid != 0)
+		{
+			g_printerr ("wrong number of valid dates from format_many\n");
+			ok = FALSE;
+		}
+
+	/* the fields are found in the template at their offsets */
+	for (i = 0; i < gtk_date_format_get_n_fields (fmt_it); i++)
+		{
+			guint offset;
+			guint width;
+			gchar field = gtk_date_format_get_field (fmt_it, i, &offset, &width);
+
+			if (field != "dmYHMS"[i]
+			    || offset + width > strlen (gtk_date_format_get_template (fmt_it))
+			    || strspn (gtk_date_format_get_template (fmt_it) + offset, "0") != width)
+				{
+					g_printerr ("wrong field %c at %u\n", field, offset);
+					ok = FALSE;
+				}
+		}
+	if (gtk_date_format_get_field (fmt_it, 6, NULL, NULL) != 0)
+		{
+			g_printerr ("field out of range not handled\n");
+			ok = FALSE;
+		}
+
+	gtk_date_format_unref (fmt);
+	gtk_date_format_unref (fmt_it);
+
+	return ok ? 0 : 1;
+}
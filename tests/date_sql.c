@@ -0,0 +1,114 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Checks gtk_date_entry_set_sql() with a date, a timestamp, an empty
+ * string and malformed ones, and its round trip with gtk_date_entry_get_sql().
+ */
+
+#include <string.h>
+
+#include <gtk/gtk.h>
+
+#include <gtkdateentry.h>
+
+int
+main (int argc, char **argv)
+{
+	GtkWidget *window;
+	GtkWidget *date;
+	GDate gdate;
+	gboolean ok;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	ok = TRUE;
+
+	window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+	date = gtk_date_entry_new ("dmY", "/", TRUE);
+	gtk_container_add (GTK_CONTAINER (window), date);
+
+	g_date_clear (&gdate, 1);
+	g_date_set_dmy (&gdate, 4, 3, 2012);
+
+	/* only the date: the time is midnight */
+	if (!gtk_date_entry_set_sql (GTK_DATE_ENTRY (date), "2012-03-04")
+	    || gtk_date_entry_get_julian (GTK_DATE_ENTRY (date)) != g_date_get_julian (&gdate)
+	    || gtk_date_entry_get_seconds (GTK_DATE_ENTRY (date)) != 0)
+		{
+			g_printerr ("sql date not set\n");
+			ok = FALSE;
+		}
+
+	/* a timestamp, and back */
+	if (!gtk_date_entry_set_sql (GTK_DATE_ENTRY (date), "2012-03-04 10:11:12")
+	    || gtk_date_entry_get_julian (GTK_DATE_ENTRY (date)) != g_date_get_julian (&gdate)
+	    || gtk_date_entry_get_seconds (GTK_DATE_ENTRY (date)) != 10 * 3600 + 11 * 60 + 12)
+		{
+			g_printerr ("sql timestamp not set\n");
+			ok = FALSE;
+		}
+	if (strcmp (gtk_date_entry_get_sql (GTK_DATE_ENTRY (date)), "2012-03-04 10:11:12") != 0)
+		{
+			g_printerr ("\"%s\" instead of 2012-03-04 10:11:12\n",
+			            gtk_date_entry_get_sql (GTK_DATE_ENTRY (date)));
+			ok = FALSE;
+		}
+
+	/* empty and NULL clear the entry, and they aren't errors */
+	if (!gtk_date_entry_set_sql (GTK_DATE_ENTRY (date), "")
+	    || gtk_date_entry_is_valid (GTK_DATE_ENTRY (date)))
+		{
+			g_printerr ("empty string doesn't clear\n");
+			ok = FALSE;
+		}
+	gtk_date_entry_set_sql (GTK_DATE_ENTRY (date), "2012-03-04");
+	if (!gtk_date_entry_set_sql (GTK_DATE_ENTRY (date), NULL)
+	    || gtk_date_entry_is_valid (GTK_DATE_ENTRY (date)))
+		{
+			g_printerr ("NULL doesn't clear\n");
+			ok = FALSE;
+		}
+
+	/* malformed: FALSE, and the entry is cleared */
+	gtk_date_entry_set_sql (GTK_DATE_ENTRY (date), "2012-03-04");
+	if (gtk_date_entry_set_sql (GTK_DATE_ENTRY (date), "2012-13-01")
+	    || gtk_date_entry_is_valid (GTK_DATE_ENTRY (date)))
+		{
+			g_printerr ("month 13 accepted\n");
+			ok = FALSE;
+		}
+	gtk_date_entry_set_sql (GTK_DATE_ENTRY (date), "2012-03-04");
+	if (gtk_date_entry_set_sql (GTK_DATE_ENTRY (date), "2012-03-04 1x:11:12")
+	    || gtk_date_entry_is_valid (GTK_DATE_ENTRY (date)))
+		{
+			g_printerr ("malformed time accepted\n");
+			ok = FALSE;
+		}
+
+	gtk_widget_destroy (window);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Checks the "valid" and "complete" properties and the error style class
+ * while the date's text is typed, also with a "min-date".
+ */
+
+#include <gtk/gtk.h>
+
+#include <gtkdateentry.h>
+
+static void
+find_entry (GtkWidget *widget, gpointer data)
+{
+	GtkWidget **entry = (GtkWidget **)data;
+
+	if (*entry != NULL)
+		{
+			return;
+		}
+
+	if (GTK_IS_ENTRY (widget) && !GTK_IS_SPIN_BUTTON (widget))
+		{
+			*entry = widget;
+		}
+	else if (GTK_IS_CONTAINER (widget))
+		{
+			gtk_container_forall (GTK_CONTAINER (widget), find_entry, data);
+		}
+}
+
+static gboolean
+check (GtkWidget *date, GtkWidget *entry, const gchar *text,
+       gboolean complete, gboolean valid, gboolean error)
+{
+	gint position;
+
+	gtk_editable_delete_text (GTK_EDITABLE (entry), 0, -1);
+	position = 0;
+	gtk_editable_insert_text (GTK_EDITABLE (entry), text, -1, &position);
+
+	if (gtk_date_entry_is_complete (GTK_DATE_ENTRY (date)) != complete
+	    || gtk_date_entry_is_valid (GTK_DATE_ENTRY (date)) != valid
+	    || gtk_style_context_has_class (gtk_widget_get_style_context (entry), GTK_STYLE_CLASS_ERROR) != error)
+		{
+			g_printerr ("wrong state for \"%s\"\n", text);
+			return FALSE;
+		}
+
+	return TRUE;
+}
+
+int
+main (int argc, char **argv)
+{
+	GtkWidget *window;
+	GtkWidget *date;
+	GtkWidget *entry;
+	gboolean ok;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	ok = TRUE;
+
+	window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+	date = gtk_date_entry_new ("dmY", "/", TRUE);
+	gtk_container_add (GTK_CONTAINER (window), date);
+
+	entry = NULL;
+	gtk_container_forall (GTK_CONTAINER (date), find_entry, &entry);
+	if (entry == NULL)
+		{
+			g_printerr ("the date's entry isn't found\n");
+			return 1;
+		}
+
+	ok = check (date, entry, "04/03/2012", TRUE, TRUE, FALSE) && ok;
+	ok = check (date, entry, "04/03", FALSE, FALSE, FALSE) && ok;
+	ok = check (date, entry, "04/13", FALSE, FALSE, TRUE) && ok;
+	ok = check (date, entry, "29/02/2012", TRUE, TRUE, FALSE) && ok;
+	ok = check (date, entry, "29/02/2013", TRUE, FALSE, TRUE) && ok;
+	ok = check (date, entry, "00/01/2013", TRUE, FALSE, TRUE) && ok;
+
+	if (ok && gtk_date_entry_get_julian (GTK_DATE_ENTRY (date)) != 0)
+		{
+			g_printerr ("an invalid date has a julian day\n");
+			ok = FALSE;
+		}
+
+	/* 2012-03-04 is 734566: the dates before it are moved to it, and the
+	 * typed ones aren't valid */
+	g_object_set (date, "min-date", 734566, NULL);
+	gtk_date_entry_set_julian_seconds (GTK_DATE_ENTRY (date), 734000, 0);
+	if (gtk_date_entry_get_julian (GTK_DATE_ENTRY (date)) != 734566)
+		{
+			g_printerr ("a date before min-date isn't moved to it\n");
+			ok = FALSE;
+		}
+	ok = check (date, entry, "03/03/2012", TRUE, FALSE, TRUE) && ok;
+	ok = check (date, entry, "05/03/2012", TRUE, TRUE, FALSE) && ok;
+
+	gtk_widget_destroy (window);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Checks the changes' tracking of the libgtkform plugin: a loaded value,
+ * or one taken with set_as_origin, isn't a change; an edit is.
+ */
+
+#include <gtk/gtk.h>
+
+#include <libgtkform/widget.h>
+
+#include <gtkdateentry.h>
+#include <gtkformwidgetdateentry.h>
+
+int
+main (int argc, char **argv)
+{
+	GtkWidget *window;
+	GtkWidget *date;
+	GtkFormWidget *fwidget;
+	gboolean ok;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	ok = TRUE;
+
+	window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+	date = gtk_date_entry_new ("dmY", "/", TRUE);
+	gtk_container_add (GTK_CONTAINER (window), date);
+
+	fwidget = gtk_form_widget_date_entry_new ();
+	gtk_form_widget_set_widget (fwidget, date);
+
+	/* a value set by the program and taken as the origin */
+	gtk_date_entry_set_sql (GTK_DATE_ENTRY (date), "2012-03-04 10:11:12");
+	gtk_form_widget_date_entry_set_as_origin (fwidget);
+	if (gtk_form_widget_date_entry_is_changed (fwidget))
+		{
+			g_printerr ("changed just after set_as_origin\n");
+			ok = FALSE;
+		}
+
+	/* an edit */
+	gtk_date_entry_set_julian_seconds (GTK_DATE_ENTRY (date),
+	                                   gtk_date_entry_get_julian (GTK_DATE_ENTRY (date)) + 1,
+	                                   gtk_date_entry_get_seconds (GTK_DATE_ENTRY (date)));
+	if (!gtk_form_widget_date_entry_is_changed (fwidget))
+		{
+			g_printerr ("not changed after an edit\n");
+			ok = FALSE;
+		}
+
+	/* the edited value taken as the new origin */
+	gtk_form_widget_date_entry_set_as_origin (fwidget);
+	if (gtk_form_widget_date_entry_is_changed (fwidget))
+		{
+			g_printerr ("changed after a second set_as_origin\n");
+			ok = FALSE;
+		}
+
+	/* a loaded value is the origin too */
+	gtk_form_widget_date_entry_set_value_stringify (fwidget, "2013-01-02");
+	if (gtk_form_widget_date_entry_is_changed (fwidget))
+		{
+			g_printerr ("changed after loading a value\n");
+			ok = FALSE;
+		}
+
+	g_object_unref (fwidget);
+	gtk_widget_destroy (window);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Checks that the locale's date format is read once and shared by the
+ * entries, and read again only after gtk_date_entry_locale_changed().
+ */
+
+#include <locale.h>
+#include <string.h>
+
+#include <gtk/gtk.h>
+
+#include <gtkdateentry.h>
+
+/* locales whose date's format isn't the one of "C", and their separators */
+static const gchar *locales[][2] =
+{
+	{ "de_DE.UTF-8", "." },
+	{ "de_DE.utf8", "." },
+	{ "it_IT.UTF-8", "/" },
+	{ "it_IT.utf8", "/" },
+	{ "fr_FR.UTF-8", "/" },
+	{ "fr_FR.utf8", "/" },
+	{ NULL, NULL }
+};
+
+static gboolean
+check_format (GtkWidget *date, const gchar *format, const gchar *separator, const gchar *what)
+{
+	gchar *f;
+	gchar *s;
+	gboolean ret;
+
+	g_object_get (date, "format", &f, "separator", &s, NULL);
+	ret = g_strcmp0 (f, format) == 0 && g_strcmp0 (s, separator) == 0;
+	if (!ret)
+		{
+			g_printerr ("%s: \"%s\" \"%s\" instead of \"%s\" \"%s\"\n",
+			            what, f, s, format, separator);
+		}
+	g_free (f);
+	g_free (s);
+
+	return ret;
+}
+
+int
+main (int argc, char **argv)
+{
+	GtkWidget *window;
+	GtkWidget *box;
+	GtkWidget *first;
+	GtkWidget *date;
+	guint i;
+	gboolean ok;
+
+	/* "C" is %m/%d/%y */
+	gtk_disable_setlocale ();
+	setlocale (LC_ALL, "C");
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	ok = TRUE;
+
+	window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+	box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+	gtk_container_add (GTK_CONTAINER (window), box);
+
+	first = gtk_date_entry_new (NULL, NULL, TRUE);
+	gtk_box_pack_start (GTK_BOX (box), first, FALSE, FALSE, 0);
+	ok &= check_format (first, "mdY", "/", "C locale");
+
+	for (i = 0; locales[i][0] != NULL; i++)
+		{
+			if (setlocale (LC_TIME, locales[i][0]) != NULL)
+				{
+					break;
+				}
+		}
+	if (locales[i][0] == NULL)
+		{
+			g_printerr ("no other locale installed: refresh not checked\n");
+			gtk_widget_destroy (window);
+			return ok ? 0 : 1;
+		}
+
+	/* the format read once is kept until the hook is called */
+	date = gtk_date_entry_new (NULL, NULL, TRUE);
+	gtk_box_pack_start (GTK_BOX (box), date, FALSE, FALSE, 0);
+	ok &= check_format (date, "mdY", "/", "before locale_changed");
+
+	/* then the new entries get the new one, the old ones keep theirs */
+	gtk_date_entry_locale_changed ();
+	date = gtk_date_entry_new (NULL, NULL, TRUE);
+	gtk_box_pack_start (GTK_BOX (box), date, FALSE, FALSE, 0);
+	ok &= check_format (date, "dmY", locales[i][1], locales[i][0]);
+	ok &= check_format (first, "mdY", "/", "entry built before locale_changed");
+
+	gtk_widget_destroy (window);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Checks that reading the date entry's content doesn't allocate memory:
+ * malloc, calloc and realloc are interposed and counted while the
+ * getters run.
+ */
+
+#include <stdlib.h>
+
+#include <gtk/gtk.h>
+
+#include <gtkdateentry.h>
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+static gboolean counting = FALSE;
+static guint allocations = 0;
+
+void
+*malloc (size_t size)
+{
+	if (counting) allocations++;
+	return __libc_malloc (size);
+}
+
+void
+*calloc (size_t nmemb, size_t size)
+{
+	if (counting) allocations++;
+	return __libc_calloc (nmemb, size);
+}
+
+void
+*realloc (void *ptr, size_t size)
+{
+	if (counting) allocations++;
+	return __libc_realloc (ptr, size);
+}
+
+static GtkWidget
+*get_masked_entry (GtkWidget *date)
+{
+	GtkWidget *hbox;
+	GList *children;
+	GtkWidget *ret;
+
+	hbox = gtk_bin_get_child (GTK_BIN (date));
+	children = gtk_container_get_children (GTK_CONTAINER (hbox));
+	ret = GTK_WIDGET (children->data);
+	g_list_free (children);
+
+	return ret;
+}
+
+static gboolean
+check (GtkWidget *date, const gchar *text, gboolean expected)
+{
+	guint i;
+	gboolean valid;
+	GDate *gdate;
+	gboolean ret;
+
+	gtk_entry_set_text (GTK_ENTRY (get_masked_entry (date)), text);
+
+	ret = TRUE;
+
+	valid = FALSE;
+	allocations = 0;
+	counting = TRUE;
+	for (i = 0; i < 1000; i++)
+		{
+			valid = gtk_date_entry_is_valid (GTK_DATE_ENTRY (date));
+		}
+	counting = FALSE;
+
+	if (valid != expected)
+		{
+			g_printerr ("\"%s\": is_valid returned %d, expected %d\n", text, valid, expected);
+			ret = FALSE;
+		}
+	if (allocations != 0)
+		{
+			g_printerr ("\"%s\": is_valid made %u allocations\n", text, allocations);
+			ret = FALSE;
+		}
+
+	/* only the returned GDate can be allocated */
+	allocations = 0;
+	counting = TRUE;
+	gdate = gtk_date_entry_get_gdate (GTK_DATE_ENTRY (date));
+	counting = FALSE;
+
+	if (allocations != (expected ? 1 : 0))
+		{
+			g_printerr ("\"%s\": get_gdate made %u allocations\n", text, allocations);
+			ret = FALSE;
+		}
+	if (gdate != NULL)
+		{
+			g_date_free (gdate);
+		}
+
+	return ret;
+}
+
+int
+main (int argc, char **argv)
+{
+	GtkWidget *date;
+	gboolean ok;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	date = gtk_date_entry_new ("dmY", "/", TRUE);
+	g_object_ref_sink (date);
+
+	ok = TRUE;
+	ok = check (date, "04/03/2012", TRUE) && ok;
+	ok = check (date, "29/02/2012", TRUE) && ok;
+	ok = check (date, "29/02/2013", FALSE) && ok;
+	ok = check (date, "31/04/2012", FALSE) && ok;
+	ok = check (date, "00/01/2012", FALSE) && ok;
+	ok = check (date, "01/13/2012", FALSE) && ok;
+	ok = check (date, "", FALSE) && ok;
+
+	g_object_unref (date);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,129 @@
+/*
+ * GtkDateEntry widget for GTK+
+ *
+ * Copyright (C) 2005-2014 Andrea Zagli <azagli@libero.it>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ */
+
+/*
+ * Checks that GtkDateEntry::value-changed is emitted once for every
+ * change of the value, once for many changes between freeze and thaw, and
+ * not at all when a setter finds the same state.
+ */
+
+#include <gtk/gtk.h>
+
+#include <gtkdateentry.h>
+
+static guint emitted = 0;
+static gint64 last = 0;
+
+static void
+on_value_changed (GtkDateEntry *date, gint64 packed, gpointer user_data)
+{
+	emitted++;
+	last = packed;
+}
+
+int
+main (int argc, char **argv)
+{
+	GtkWidget *window;
+	GtkWidget *date;
+	GDateTime *gdatetime;
+	guint applied;
+	guint skipped;
+	guint n;
+	gboolean ok;
+
+	if (!gtk_init_check (&argc, &argv))
+		{
+			/* no display: skip */
+			return 77;
+		}
+
+	ok = TRUE;
+
+	window = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+	date = gtk_date_entry_new ("dmY", "/", TRUE);
+	gtk_container_add (GTK_CONTAINER (window), date);
+	g_signal_connect (date, "value-changed", G_CALLBACK (on_value_changed), NULL);
+
+	/* the text and the three spins change: one signal */
+	gdatetime = g_date_time_new_local (2012, 3, 4, 10, 11, 12);
+	gtk_date_entry_set_date_gdatetime (GTK_DATE_ENTRY (date), gdatetime);
+	g_date_time_unref (gdatetime);
+	if (emitted != 1
+	    || last != gtk_date_entry_get_packed (GTK_DATE_ENTRY (date))
+	    || GTK_DATE_ENTRY_PACKED_JULIAN (last) != gtk_date_entry_get_julian (GTK_DATE_ENTRY (date))
+	    || GTK_DATE_ENTRY_PACKED_SECONDS (last) != 10 * 3600 + 11 * 60 + 12)
+		{
+			g_printerr ("%u signals instead of 1 for a setter\n", emitted);
+			ok = FALSE;
+		}
+
+	/* the same value and the same format: no signal, and in a debug build
+	 * the setters are counted as skipped */
+	emitted = 0;
+	gtk_date_entry_get_update_counters (NULL, &skipped);
+	gtk_date_entry_set_julian_seconds (GTK_DATE_ENTRY (date),
+	                                   gtk_date_entry_get_julian (GTK_DATE_ENTRY (date)),
+	                                   gtk_date_entry_get_seconds (GTK_DATE_ENTRY (date)));
+	gtk_date_entry_set_format (GTK_DATE_ENTRY (date), "dmY");
+	gtk_date_entry_set_separator (GTK_DATE_ENTRY (date), "/");
+	if (emitted != 0)
+		{
+			g_printerr ("%u signals instead of 0 for the same value\n", emitted);
+			ok = FALSE;
+		}
+	gtk_date_entry_get_update_counters (&applied, &n);
+	if (applied > 0 && n != skipped + 3)
+		{
+			g_printerr ("%u setters skipped instead of 3\n", n - skipped);
+			ok = FALSE;
+		}
+
+	/* many setters while frozen: one signal when thawed */
+	gtk_date_entry_freeze_value_changed (GTK_DATE_ENTRY (date));
+	gtk_date_entry_set_julian_seconds (GTK_DATE_ENTRY (date), 734566, 0);
+	gtk_date_entry_set_julian_seconds (GTK_DATE_ENTRY (date), 734567, 60);
+	gtk_date_entry_set_julian_seconds (GTK_DATE_ENTRY (date), 734568, 120);
+	if (emitted != 0)
+		{
+			g_printerr ("signal emitted while frozen\n");
+			ok = FALSE;
+		}
+	gtk_date_entry_thaw_value_changed (GTK_DATE_ENTRY (date));
+	if (emitted != 1 || last != GTK_DATE_ENTRY_PACK (734568, 120))
+		{
+			g_printerr ("%u signals instead of 1 after thawing\n", emitted);
+			ok = FALSE;
+		}
+
+	/* cleared: 0 */
+	emitted = 0;
+	gtk_date_entry_set_date_gdatetime (GTK_DATE_ENTRY (date), NULL);
+	if (emitted != 1 || last != 0)
+		{
+			g_printerr ("clearing doesn't emit 0\n");
+			ok = FALSE;
+		}
+
+	gtk_widget_destroy (window);
+
+	return ok ? 0 : 1;
+}